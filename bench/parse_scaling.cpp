@@ -0,0 +1,337 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+// Feeds the parser generated worst cases at doubling sizes and records parse
+// time and PEG memo usage for each. Policies are machine-generated, so a
+// shape that makes the parser superlinear (e.g. in the left-recursion bound)
+// would stall whoever loads them. Fails if, from the smallest size to the
+// largest, any measure grows faster than n log n (n being the number of
+// tokens) by more than a slack factor.
+//
+// With --quick, sizes are small enough to run as a test.
+
+#include <fekal/parser.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <iostream>
+#include <format>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#if defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#error Without memoization the parser is exponential on nested input
+#elif defined(FEKAL_PEG_HASHED_MEMOIZATION)
+static constexpr const char* store = "hashed";
+
+// Its parse time grows faster than the input once the memo outgrows the CPU
+// caches (see its cache_type), so only its memo figures are checked
+static constexpr bool check_time = false;
+#else
+static constexpr const char* store = "dense";
+static constexpr bool check_time = true;
+#endif
+
+#if defined(FEKAL_PRECEDENCE_CLIMBING)
+static constexpr const char* expressions = "climbing";
+#else
+static constexpr const char* expressions = "peg";
+#endif
+
+// Time per token also depends on which cache level the working set of a parse
+// fits in, and the largest sizes outgrow the CPU caches (a 100k-term `+` chain
+// needs about 30 MiB). On a machine with 2 MiB of L2, time grew by up to 1.7x
+// the bound in either mode. Quadratic parsing would still fail by far, growing
+// about six times past the bound. Memo figures are deterministic.
+static constexpr double time_slack = 2.5;
+static constexpr double memo_slack = 1.5;
+
+// Each size is parsed at least `min_rounds` times and for at least
+// `min_total_ms`, so the small sizes get enough rounds for their best time to
+// settle
+static constexpr unsigned min_rounds = 5;
+static constexpr double min_total_ms = 250;
+
+// Filters per policy in the nesting families, so the smaller sizes don't
+// finish within timer noise
+static constexpr unsigned nested_filters = 64;
+
+static std::string policy(std::string_view name, std::string_view filters)
+{
+    return std::format(
+        "POLICY {} 0 {{\n"
+        "    ALLOW {{\n"
+        "{}"
+        "    }}\n"
+        "}}\n",
+        name, filters);
+}
+
+static std::string filter(std::string_view expr, bool last = true)
+{
+    return std::format(
+        "        read(fd, buf, count) {{ {} }}{}\n", expr, last ? "" : ",");
+}
+
+// fd == 0 || fd == 1 || ... with `n` terms
+static std::string or_chain(unsigned n)
+{
+    std::string ret;
+    for (unsigned i = 0 ; i < n ; ++i) {
+        ret += std::format("{}fd == {}", i == 0 ? "" : " || ", i % 1000);
+    }
+    return ret;
+}
+
+// fd == 0 + 1 + ... with `n` terms on the right
+static std::string sum_chain(unsigned n)
+{
+    std::string ret = "fd == ";
+    for (unsigned i = 0 ; i < n ; ++i) {
+        ret += std::format("{}{}", i == 0 ? "" : " + ", i % 1000);
+    }
+    return ret;
+}
+
+static std::string nested(std::string_view open, std::string_view inner,
+                          unsigned depth, unsigned missing = 0)
+{
+    std::string ret;
+    for (unsigned i = 0 ; i < depth ; ++i) {
+        ret += open;
+    }
+    ret += inner;
+    ret.append(depth - missing, ')');
+    return ret;
+}
+
+// Only the last filter misses `missing` closing parentheses, so everything
+// before it has to match first
+static std::string nested_filters_policy(
+    std::string_view open, std::string_view prefix, std::string_view inner,
+    unsigned depth, unsigned missing = 0)
+{
+    std::string filters;
+    for (unsigned i = 0 ; i < nested_filters ; ++i) {
+        bool last = i + 1 == nested_filters;
+        filters += filter(
+            std::format(
+                "{}{}", prefix,
+                nested(open, inner, depth, last ? missing : 0)),
+            last);
+    }
+    return policy("P", filters);
+}
+
+struct Family
+{
+    const char* name;
+    const char* description;
+
+    // sizes are min_size, 2 * min_size, 4 * min_size and 8 * min_size
+    unsigned min_size;
+    unsigned quick_min_size;
+
+    std::function<std::string(unsigned)> generate;
+
+    // near-miss inputs must fail after trying every way to match
+    bool rejected = false;
+};
+
+static std::vector<Family> families()
+{
+    return {
+        {
+            "or-chain", "one filter with n `||` terms",
+            12'500, 1'000,
+            [](unsigned n) { return policy("P", filter(or_chain(n))); },
+        },
+        {
+            "sum-chain", "one filter with n `+` terms",
+            12'500, 1'000,
+            [](unsigned n) { return policy("P", filter(sum_chain(n))); },
+        },
+        {
+            "int-parens", "filters nesting n `(` in a Term",
+            32, 16,
+            [](unsigned n) {
+                return nested_filters_policy("(", "fd == ", "1", n);
+            },
+        },
+        {
+            "bool-parens", "filters nesting n `(` around a comparison",
+            32, 16,
+            [](unsigned n) {
+                return nested_filters_policy("(", "", "fd == 1", n);
+            },
+        },
+        {
+            "policies", "n policies of 32 filters",
+            250, 25,
+            [](unsigned n) {
+                std::string filters;
+                for (unsigned i = 0 ; i < 32 ; ++i) {
+                    filters += filter(
+                        std::format(
+                            "fd == {} && count < 4096 || !(buf & 0xff == 0)",
+                            i),
+                        i == 31);
+                }
+                std::string ret;
+                for (unsigned i = 0 ; i < n ; ++i) {
+                    ret += policy(std::format("P{}", i), filters);
+                }
+                return ret;
+            },
+        },
+        {
+            "near-miss-chain", "an `||` chain of n terms ending in `||`",
+            12'500, 1'000,
+            [](unsigned n) {
+                return policy("P", filter(or_chain(n) + " ||"));
+            },
+            true,
+        },
+        {
+            "near-miss-sum", "a `+` chain of n terms ending in `+`",
+            12'500, 1'000,
+            [](unsigned n) {
+                return policy("P", filter(sum_chain(n) + " +"));
+            },
+            true,
+        },
+        {
+            "near-miss-parens", "nesting n `(`, the last one left unclosed",
+            32, 16,
+            [](unsigned n) {
+                return nested_filters_policy("!(", "", "fd == (1)", n, 1);
+            },
+            true,
+        },
+    };
+}
+
+struct Sample
+{
+    unsigned size;
+    fekal::ParseStats stats;
+    double ms;
+};
+
+// Best of the rounds. Returns false if the input wasn't accepted (or
+// rejected) as expected.
+static bool measure(const Family& family, unsigned size, Sample& sample)
+{
+    auto input = family.generate(size);
+    sample = {size, {}, 0.0};
+
+    using clock = std::chrono::steady_clock;
+    double total = 0;
+    for (unsigned i = 0 ; i < min_rounds || total < min_total_ms ; ++i) {
+        // destroyed after the clock stops, as tearing down deep trees isn't
+        // parsing
+        std::vector<fekal::ast::ProgramStatement> ast;
+        bool rejected = false;
+        auto start = clock::now();
+        try {
+            ast = fekal::parse(input, sample.stats);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        std::chrono::duration<double, std::milli> elapsed =
+            clock::now() - start;
+
+        if (rejected != family.rejected) {
+            std::cerr << std::format(
+                "{} at {}: input unexpectedly {}\n", family.name, size,
+                rejected ? "rejected" : "accepted");
+            return false;
+        }
+        if (i == 0 || elapsed.count() < sample.ms) {
+            sample.ms = elapsed.count();
+        }
+        total += elapsed.count();
+    }
+    return true;
+}
+
+// How much f(n) = n log n grows from `n1` to `n2`
+static double nlogn_growth(std::size_t n1, std::size_t n2)
+{
+    return (n2 * std::log2(n2)) / (n1 * std::log2(n1));
+}
+
+static bool within(const char* what, double from, double to, double bound,
+                   double slack)
+{
+    // nothing to grow from
+    if (from == 0) {
+        return to == 0;
+    }
+
+    double growth = to / from;
+    bool ok = growth <= bound * slack;
+    std::cout << std::format(
+        "    {:<12} x{:<8.2f} {}\n", what, growth, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    bool quick = argc > 1 && std::string_view{argv[1]} == "--quick";
+    if (argc > 2 || (argc == 2 && !quick)) {
+        std::cerr << "Usage: " << argv[0] << " [--quick]\n";
+        return 1;
+    }
+
+    std::cout << std::format("store: {}, exprs: {}\n\n", store, expressions);
+
+    bool ok = true;
+    for (const auto& family : families()) {
+        std::cout << std::format(
+            "{}: {}\n{:>10} {:>10} {:>10} {:>12} {:>12}\n",
+            family.name, family.description, "n", "tokens", "best_ms",
+            "memo_entries", "memo_KiB");
+
+        std::vector<Sample> samples;
+        auto min_size = quick ? family.quick_min_size : family.min_size;
+        for (auto size = min_size ; size <= 8 * min_size ; size *= 2) {
+            Sample sample;
+            if (!measure(family, size, sample)) {
+                return 1;
+            }
+            samples.push_back(sample);
+            std::cout << std::format(
+                "{:>10} {:>10} {:>10.2f} {:>12} {:>12.1f}\n",
+                size, sample.stats.tokens, sample.ms,
+                sample.stats.memo_entries, sample.stats.memo_bytes / 1024.0);
+        }
+
+        const auto& first = samples.front();
+        const auto& last = samples.back();
+        double bound = nlogn_growth(first.stats.tokens, last.stats.tokens);
+        std::cout << std::format("  growth (n log n: x{:.2f})\n", bound);
+        if (check_time) {
+            ok &= within("time", first.ms, last.ms, bound, time_slack);
+        } else {
+            std::cout << std::format(
+                "    {:<12} x{:<8.2f} not checked\n", "time",
+                last.ms / first.ms);
+        }
+        ok &= within(
+            "memo_entries", first.stats.memo_entries, last.stats.memo_entries,
+            bound, memo_slack);
+        ok &= within(
+            "memo_bytes", first.stats.memo_bytes, last.stats.memo_bytes,
+            bound, memo_slack);
+        std::cout << '\n';
+    }
+
+    if (!ok) {
+        std::cerr << "parsing grows faster than O(n log n)\n";
+        return 1;
+    }
+    return 0;
+}
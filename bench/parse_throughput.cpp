@@ -0,0 +1,112 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+// Measures the parser alone over a generated library. The PEG memo store and
+// the expression parser are chosen at compile time, so the same source is
+// built once per variant (see bench/meson.build) and the reports are compared
+// side by side.
+
+#include <fekal/parser.hpp>
+#include <fekal/reader.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <format>
+#include <chrono>
+#include <vector>
+
+#if defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+static constexpr const char* store = "unmemoized";
+static constexpr unsigned default_statements = 50;
+#elif defined(FEKAL_PEG_HASHED_MEMOIZATION)
+static constexpr const char* store = "hashed";
+static constexpr unsigned default_statements = 5000;
+#else
+static constexpr const char* store = "dense";
+static constexpr unsigned default_statements = 5000;
+#endif
+
+#if defined(FEKAL_PRECEDENCE_CLIMBING)
+static constexpr const char* expressions = "climbing";
+#else
+static constexpr const char* expressions = "peg";
+#endif
+
+// Without memoization, the parser backtracks exponentially on nesting depth,
+// so the expressions are kept flat.
+static std::string generated_library(unsigned n)
+{
+    std::string ret;
+    for (unsigned i = 0 ; i < n ; ++i) {
+        ret += std::format(
+            "POLICY P{} 0 {{\n"
+            "    ALLOW {{\n"
+            "        read(fd, buf, count) {{\n"
+            "            fd == {} && count < 4096 && !(count == 0)\n"
+            "        }},\n"
+            "        ioctl(fd, request) {{\n"
+            "            request & 0xffff == {} || fd + 1 != 2\n"
+            "        }}\n"
+            "    }}\n"
+            "    ERRNO(1) {{\n"
+            "        socket(domain) {{ domain == 1 || domain == 10 }}\n"
+            "    }}\n"
+            "}}\n",
+            i, i % 64, i);
+    }
+    return ret;
+}
+
+static std::size_t count_tokens(std::string_view input)
+{
+    std::size_t ret = 0;
+    for (fekal::reader r{input} ; r.symbol() != fekal::token::symbol::END ;
+         r.next()) {
+        ++ret;
+    }
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned statements = argc > 1 ? std::stoul(argv[1]) : default_statements;
+    unsigned rounds = argc > 2 ? std::stoul(argv[2]) : 10;
+    if (statements == 0 || rounds == 0) {
+        std::cerr << "Usage: " << argv[0] << " [statements] [rounds]\n";
+        return 1;
+    }
+
+    auto library = generated_library(statements);
+    auto tokens = count_tokens(library);
+
+    using clock = std::chrono::steady_clock;
+    std::vector<double> samples(rounds);
+    std::size_t parsed = 0;
+    for (auto& sample : samples) {
+        auto start = clock::now();
+        parsed += fekal::parse(library).size();
+        std::chrono::duration<double, std::milli> elapsed =
+            clock::now() - start;
+        sample = elapsed.count();
+    }
+    if (parsed != std::size_t{statements} * rounds) {
+        std::cerr << "unexpected number of statements\n";
+        return 1;
+    }
+
+    std::ranges::sort(samples);
+    double best = samples.front();
+    double median = samples[samples.size() / 2];
+
+    std::cout << std::format(
+        "{:<11} {:<9} {:>9} {:>8} {:>9} {:>9} {:>8} {:>9}\n",
+        "store", "exprs", "bytes", "tokens", "best_ms", "median_ms", "MiB/s",
+        "ns/token");
+    std::cout << std::format(
+        "{:<11} {:<9} {:>9} {:>8} {:>9.2f} {:>9.2f} {:>8.1f} {:>9.1f}\n",
+        store, expressions, library.size(), tokens, best, median,
+        library.size() / (median / 1000.0) / (1024 * 1024),
+        median * 1e6 / tokens);
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+// Measures the in-kernel cost of each policy from a library file. Every policy
+// is compiled for the native arch and installed in a forked child which then
+// times a fixed syscall mix with and without the filter.
+
+#include <fekal/compiler.hpp>
+#include <fekal/parser.hpp>
+#include <fekal/sourcefile.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <format>
+#include <cstdint>
+#include <chrono>
+#include <array>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+
+static constexpr unsigned BATCH = 64;
+
+using Args = std::array<std::uint64_t, 6>;
+
+static std::uint64_t arg(const void* p)
+{
+    return reinterpret_cast<std::uintptr_t>(p);
+}
+
+static int dev_zero = -1;
+static int futex_word = 0;
+static char read_buffer;
+static timespec clock_buffer;
+
+struct Syscall
+{
+    const char* name;
+    long nr;
+
+    // Passed to every call, and to the emulator to tell whether the filter
+    // allows the call
+    Args (*args)();
+};
+
+// Syscalls are issued directly, so the vDSO is bypassed on purpose
+static const std::array mix{
+    Syscall{"getpid", SYS_getpid, []() { return Args{}; }},
+    Syscall{"read", SYS_read, []() {
+        return Args{
+            static_cast<std::uint64_t>(dev_zero), arg(&read_buffer), 1};
+    }},
+    Syscall{"futex", SYS_futex, []() {
+        return Args{arg(&futex_word), FUTEX_WAKE_PRIVATE, 1};
+    }},
+    Syscall{"clock_gettime", SYS_clock_gettime, []() {
+        return Args{CLOCK_MONOTONIC, arg(&clock_buffer)};
+    }},
+};
+
+// Nanoseconds per syscall for each batch. The buffer is allocated in advance
+// as the filter might deny brk/mmap.
+static void measure(const Syscall& s, std::span<double> samples)
+{
+    using clock = std::chrono::steady_clock;
+    auto a = s.args();
+    for (auto& sample : samples) {
+        auto start = clock::now();
+        for (unsigned i = 0 ; i < BATCH ; ++i) {
+            syscall(s.nr, a[0], a[1], a[2], a[3], a[4], a[5]);
+        }
+        std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+        sample = elapsed.count() / BATCH;
+    }
+}
+
+static bool write_all(int fd, std::span<const double> data)
+{
+    auto bytes = std::as_bytes(data);
+    while (!bytes.empty()) {
+        auto n = write(fd, bytes.data(), bytes.size());
+        if (n < 0) {
+            return false;
+        }
+        bytes = bytes.subspan(n);
+    }
+    return true;
+}
+
+// Layout: for each syscall in the mix, the unfiltered samples followed by
+// the filtered samples.
+static std::vector<double> run_child(
+    const fekal::bpf::Program& program, unsigned nsamples)
+{
+    std::vector<double> samples(mix.size() * 2 * nsamples);
+
+    int fds[2];
+    if (pipe(fds) == -1) {
+        throw std::system_error{errno, std::system_category()};
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        throw std::system_error{errno, std::system_category()};
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        sock_fprog prog{
+            .len = static_cast<unsigned short>(program.size()),
+            .filter = const_cast<sock_filter*>(program.data()),
+        };
+        std::span<double> out{samples};
+        for (std::size_t i = 0 ; i < mix.size() ; ++i) {
+            measure(mix[i], out.subspan(2 * i * nsamples, nsamples));
+        }
+        if (
+            prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == -1 ||
+            syscall(SYS_seccomp, SECCOMP_SET_MODE_FILTER, 0, &prog) == -1
+        ) {
+            _exit(1);
+        }
+        for (std::size_t i = 0 ; i < mix.size() ; ++i) {
+            measure(mix[i], out.subspan((2 * i + 1) * nsamples, nsamples));
+        }
+        _exit(write_all(fds[1], samples) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    auto bytes = std::as_writable_bytes(std::span{samples});
+    while (!bytes.empty()) {
+        auto n = read(fds[0], bytes.data(), bytes.size());
+        if (n <= 0) {
+            break;
+        }
+        bytes = bytes.subspan(n);
+    }
+    close(fds[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !bytes.empty()) {
+        throw std::runtime_error{"benchmark child failed"};
+    }
+    return samples;
+}
+
+struct Stats
+{
+    double mean;
+    double p99;
+};
+
+static Stats stats(std::span<double> samples)
+{
+    std::ranges::sort(samples);
+    double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+    auto idx = std::min(samples.size() - 1, samples.size() * 99 / 100);
+    return {sum / samples.size(), samples[idx]};
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <policies.fekal> [samples]\n";
+        return 1;
+    }
+
+    unsigned nsamples = argc > 2 ? std::stoul(argv[2]) : 2000;
+
+    auto source_file = fekal::SourceFile::open(argv[1]);
+    auto library = source_file.text();
+
+    dev_zero = open("/dev/zero", O_RDONLY | O_CLOEXEC);
+    if (dev_zero == -1) {
+        throw std::system_error{errno, std::system_category()};
+    }
+
+    std::cout << std::format(
+        "{:<20} {:>5} {:<14} {:>7} {:>9} {:>9} {:>9} {:>9} {:>9}\n",
+        "policy", "insns", "syscall", "allowed", "base_mean", "base_p99",
+        "filt_mean", "filt_p99", "overhead");
+
+    for (const auto& stmt : fekal::parse(library)) {
+        auto policy = std::get_if<fekal::ast::Policy>(&stmt);
+        if (!policy) {
+            continue;
+        }
+
+        // Denied syscalls fail fast instead of killing the child, and the
+        // child can still report back.
+        auto source = std::format(
+            "{}\nUSE {} {}\nALLOW {{ write, exit_group }}\n"
+            "DEFAULT ERRNO(38)\n",
+            library, policy->name, policy->version);
+
+        fekal::Compiler compiler;
+        auto ast = compiler.compile(source);
+        auto program = compiler.codegen(
+            ast, std::span{&fekal::native_arch(), 1});
+        if (compiler.diagnostics.has_errors()) {
+            compiler.print_errors();
+            return 1;
+        }
+
+        auto samples = run_child(program, nsamples);
+        for (std::size_t i = 0 ; i < mix.size() ; ++i) {
+            std::span<double> all{samples};
+            auto base = stats(all.subspan(2 * i * nsamples, nsamples));
+            auto filt = stats(all.subspan((2 * i + 1) * nsamples, nsamples));
+
+            // Denied syscalls skip the work done by the kernel, so their
+            // overhead isn't comparable to the allowed ones.
+            seccomp_data data{
+                .nr = static_cast<int>(mix[i].nr),
+                .arch = fekal::native_arch().token,
+            };
+            std::ranges::copy(mix[i].args(), data.args);
+            bool allowed = fekal::bpf::emulate(program, data).action ==
+                SECCOMP_RET_ALLOW;
+
+            std::cout << std::format(
+                "{:<20} {:>5} {:<14} {:>7} {:>9.1f} {:>9.1f} {:>9.1f} "
+                "{:>9.1f} {:>9.1f}\n",
+                policy->name, program.size(), mix[i].name,
+                allowed ? "yes" : "no", base.mean, base.p99, filt.mean,
+                filt.p99, filt.mean - base.mean);
+        }
+    }
+
+    return 0;
+}
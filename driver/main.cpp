@@ -1,8 +1,7 @@
 // Copyright (c) 2025 Vinícius dos Santos Oliveira
 // SPDX-License-Identifier: MIT-0
 
-#include <istream>
-#include <fstream>
+#include <fekal/sourcefile.hpp>
 #include <fekal/parser.hpp>
 #include <fekal/compiler.hpp>
 #include <fekal/printer.hpp>
@@ -11,31 +10,7 @@
 #include <term.h>
 #include <curses.h>
 
-static std::string read_file(std::istream& s)
-{
-    std::string ret;
-
-    std::streampos sz;
-    s.seekg(0, std::ios::end);
-    sz = s.tellg();
-    s.seekg(0, std::ios::beg);
-
-    if (s.rdstate() != std::ios_base::goodbit) {
-        throw std::system_error{std::io_errc::stream};
-    }
-
-    if (sz == 0)
-        return ret;
-
-    ret.resize(sz);
-    s.read(ret.data(), sz);
-
-    if (s.rdstate() != std::ios_base::goodbit) {
-        throw std::system_error{std::io_errc::stream};
-    }
-
-    return ret;
-}
+#include "replay.hpp"
 
 bool has_color()
 {
@@ -54,11 +29,21 @@ bool has_color()
 
 int main(int argc, char* argv[])
 {
-    std::ifstream in{argv[1], std::ios::in | std::ios::binary};
-    std::string source = read_file(in);
+    if (argc > 1 && std::string_view{argv[1]} == "replay") {
+        try {
+            return replay(argc, argv, has_color());
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    bool check_all = argc > 2 && std::string_view{argv[1]} == "--check-all";
     try {
+        auto source = fekal::SourceFile::open(argv[check_all ? 2 : 1]);
         auto compiler = fekal::Compiler{has_color()};
-        auto ast = compiler.compile(source);
+        compiler.check_all = check_all;
+        auto ast = compiler.compile(source.text());
         compiler.print_errors();
         fekal::print(std::cout, ast);
     } catch (const std::exception& e) {
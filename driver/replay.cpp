@@ -0,0 +1,309 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include "replay.hpp"
+
+#include <fekal/compiler.hpp>
+#include <fekal/sourcefile.hpp>
+#include <algorithm>
+#include <iostream>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <map>
+
+namespace {
+
+struct Record
+{
+    seccomp_data data;
+
+    // Empty when the trace only provides the number
+    std::string name;
+};
+
+struct Trace
+{
+    std::vector<Record> records;
+
+    // Lines or records that couldn't be replayed
+    std::size_t skipped = 0;
+};
+
+// strace prints numbers as decimal (possibly negative), hex or octal (e.g.
+// file modes).
+std::optional<std::uint64_t> parse_integer(std::string_view v)
+{
+    bool negative = v.starts_with('-');
+    if (negative) {
+        v.remove_prefix(1);
+    }
+    int base = 10;
+    if (v.starts_with("0x")) {
+        v.remove_prefix(2);
+        base = 16;
+    } else if (v.size() > 1 && v.starts_with('0')) {
+        v.remove_prefix(1);
+        base = 8;
+    }
+    std::uint64_t ret;
+    auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), ret, base);
+    if (ec != std::errc{} || ptr != v.data() + v.size() || v.empty()) {
+        return std::nullopt;
+    }
+    return negative ? -ret : ret;
+}
+
+// Splits the argument list at top-level commas. Stops at the closing
+// parenthesis or wherever strace cut the line (<unfinished ...>).
+std::vector<std::string_view> split_args(std::string_view s)
+{
+    std::vector<std::string_view> ret;
+    unsigned nesting = 0;
+    bool in_string = false;
+    std::size_t start = 0;
+    std::size_t i = 0;
+    for (; i < s.size() ; ++i) {
+        char c = s[i];
+        if (in_string) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                in_string = false;
+            }
+            continue;
+        }
+        if (c == '"') {
+            in_string = true;
+        } else if (c == '(' || c == '[' || c == '{') {
+            ++nesting;
+        } else if (c == ']' || c == '}') {
+            --nesting;
+        } else if (c == ')') {
+            if (nesting == 0) {
+                break;
+            }
+            --nesting;
+        } else if (c == ',' && nesting == 0) {
+            ret.push_back(s.substr(start, i - start));
+            start = i + 1;
+        } else if (nesting == 0 && s.substr(i).starts_with(" <unfinished")) {
+            break;
+        }
+    }
+    auto last = s.substr(start, i - start);
+    if (last.find_first_not_of(' ') != last.npos) {
+        ret.push_back(last);
+    }
+    return ret;
+}
+
+std::string_view trim(std::string_view s)
+{
+    auto b = s.find_first_not_of(' ');
+    if (b == s.npos) {
+        return {};
+    }
+    return s.substr(b, s.find_last_not_of(' ') - b + 1);
+}
+
+Trace parse_strace(std::string_view text, const fekal::Arch& arch)
+{
+    Trace trace;
+    auto is_name_char = [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+    };
+
+    while (!text.empty()) {
+        auto eol = text.find('\n');
+        auto line = text.substr(0, eol);
+        text.remove_prefix(eol == text.npos ? text.size() : eol + 1);
+
+        // -f prefixes: "[pid 123] " or "123 "
+        if (line.starts_with("[pid ")) {
+            line.remove_prefix(std::min(line.find(']') + 2, line.size()));
+        } else if (auto sp = line.find(' ') ; sp != line.npos &&
+                   line.substr(0, sp).find_first_not_of("0123456789") ==
+                   line.npos) {
+            line.remove_prefix(sp + 1);
+        }
+
+        // signals, exits and the second half of interrupted syscalls
+        if (
+            line.empty() || line.starts_with("---") ||
+            line.starts_with("+++") || line.starts_with("<...")
+        ) {
+            continue;
+        }
+
+        std::size_t n = 0;
+        while (n < line.size() && is_name_char(line[n])) {
+            ++n;
+        }
+        if (n == 0 || n == line.size() || line[n] != '(') {
+            ++trace.skipped;
+            continue;
+        }
+
+        Record record{{}, std::string{line.substr(0, n)}};
+        auto nr = fekal::resolve_syscall(arch, record.name);
+        if (!nr) {
+            ++trace.skipped;
+            continue;
+        }
+        record.data.nr = static_cast<int>(*nr);
+        record.data.arch = arch.token;
+        auto args = split_args(line.substr(n + 1));
+        for (std::size_t i = 0 ; i < args.size() && i < 6 ; ++i) {
+            auto v = parse_integer(trim(args[i])).value_or(0);
+            if (!arch.is_64bit) {
+                v &= 0xffffffff;
+            }
+            record.data.args[i] = v;
+        }
+        trace.records.push_back(std::move(record));
+    }
+    return trace;
+}
+
+Trace parse_raw(std::string_view bytes)
+{
+    Trace trace;
+    while (bytes.size() >= sizeof(seccomp_data)) {
+        Record record{};
+        std::memcpy(&record.data, bytes.data(), sizeof(seccomp_data));
+        bytes.remove_prefix(sizeof(seccomp_data));
+        trace.records.push_back(std::move(record));
+    }
+    // truncated record at the end
+    trace.skipped = bytes.empty() ? 0 : 1;
+    return trace;
+}
+
+unsigned percentile(std::span<const unsigned> sorted, unsigned p)
+{
+    auto idx = std::min(sorted.size() - 1, sorted.size() * p / 100);
+    return sorted[idx];
+}
+
+void usage(const char* prog)
+{
+    std::cerr << "Usage: " << prog << " replay [--arch <name>] "
+        "[--format strace|raw] [-O<level>] [-f[no-]<pass>] [-j[<jobs>]] "
+        "[--time-passes] [--check-all] <policy.fekal> <trace>\n";
+}
+
+} // namespace
+
+int replay(int argc, char* argv[], bool stdout_has_colors)
+{
+    auto compiler = fekal::Compiler{stdout_has_colors};
+    const fekal::Arch* arch = &fekal::native_arch();
+    std::string_view format = "strace";
+    int i = 2;
+    for (; i < argc ; ++i) {
+        std::string_view opt = argv[i];
+        if (opt == "--arch" && i + 1 < argc) {
+            arch = fekal::find_arch(argv[++i]);
+            if (!arch) {
+                std::cerr << "Unsupported arch: " << argv[i] << '\n';
+                return 1;
+            }
+        } else if (opt == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (opt == "--time-passes") {
+            compiler.passes.time_passes = true;
+        } else if (opt == "--check-all") {
+            compiler.check_all = true;
+        } else if (!compiler.passes.parse_option(opt)) {
+            break;
+        }
+    }
+    if (argc - i != 2 || (format != "strace" && format != "raw")) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    auto source = fekal::SourceFile::open(argv[i]);
+    auto ast = compiler.compile(source.text());
+    auto program = compiler.codegen(ast, std::span{arch, 1});
+    compiler.print_errors();
+    if (compiler.diagnostics.has_errors()) {
+        return 1;
+    }
+    if (compiler.passes.time_passes) {
+        compiler.passes.print_timings(std::cout);
+        std::cout << '\n';
+    }
+
+    auto input = fekal::SourceFile::open(argv[i + 1]);
+    auto trace = format == "raw" ? parse_raw(input.text()) :
+        parse_strace(input.text(), *arch);
+    if (trace.records.empty()) {
+        std::cerr << "No syscalls to replay\n";
+        return 1;
+    }
+
+    struct Breakdown
+    {
+        std::size_t count = 0;
+        std::size_t total = 0;
+        unsigned max = 0;
+    };
+    std::map<std::string, Breakdown> by_syscall;
+    std::vector<unsigned> executed;
+    executed.reserve(trace.records.size());
+    for (const auto& record : trace.records) {
+        auto r = fekal::bpf::emulate(program, record.data);
+        executed.push_back(r.executed);
+
+        auto name = record.name;
+        if (name.empty()) {
+            auto a = std::ranges::find(
+                fekal::supported_archs(), record.data.arch,
+                &fekal::Arch::token);
+            if (a != fekal::supported_archs().end()) {
+                name = fekal::syscall_name(
+                    *a, static_cast<std::uint32_t>(record.data.nr));
+            }
+            if (name.empty()) {
+                name = std::format("{}:{}", record.data.arch, record.data.nr);
+            }
+        }
+        auto& b = by_syscall[name];
+        ++b.count;
+        b.total += r.executed;
+        b.max = std::max(b.max, r.executed);
+    }
+
+    std::size_t total = 0;
+    for (auto e : executed) {
+        total += e;
+    }
+    std::ranges::sort(executed);
+
+    std::cout << std::format(
+        "{} instructions, {} syscalls replayed ({} skipped)\n",
+        program.size(), executed.size(), trace.skipped);
+    std::cout << std::format(
+        "executed per syscall: mean {:.2f} p50 {} p90 {} p99 {} max {}\n\n",
+        static_cast<double>(total) / executed.size(), percentile(executed, 50),
+        percentile(executed, 90), percentile(executed, 99), executed.back());
+
+    std::vector<std::pair<std::string, Breakdown>> rows(
+        by_syscall.begin(), by_syscall.end());
+    // heaviest contributors first
+    std::ranges::stable_sort(rows, std::greater{}, [](const auto& row) {
+        return row.second.total;
+    });
+    std::cout << std::format(
+        "{:<24} {:>10} {:>8} {:>5} {:>7}\n",
+        "syscall", "count", "mean", "max", "share");
+    for (const auto& [name, b] : rows) {
+        std::cout << std::format(
+            "{:<24} {:>10} {:>8.2f} {:>5} {:>6.1f}%\n",
+            name, b.count, static_cast<double>(b.total) / b.count, b.max,
+            100.0 * b.total / total);
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+// fekal replay [--arch <name>] [--format strace|raw] [-O<level>]
+//              [-f[no-]<pass>] [--time-passes] <policy> <trace>
+//
+// Runs a recorded stream of syscalls through the emulated filter of the given
+// policy and reports how many BPF instructions each syscall executed, so
+// optimiser settings can be compared offline.
+//
+// Two trace formats are accepted:
+//
+// - strace: output from `strace -f -X raw -e raw=all`. Arguments that strace
+//   didn't print as integers (strings, structs) are replayed as 0.
+// - raw: consecutive `struct seccomp_data` records in native byte order.
+int replay(int argc, char* argv[], bool stdout_has_colors);
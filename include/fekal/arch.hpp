@@ -0,0 +1,46 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <string>
+#include <span>
+
+namespace fekal {
+
+struct Arch
+{
+    std::string_view name;
+
+    // AUDIT_ARCH_* value as found in seccomp_data::arch
+    std::uint32_t token;
+
+    // False on 32-bit archs, whose arguments are zero-extended, so the high
+    // half of every argument is known to be zero
+    bool is_64bit;
+
+    // Syscall numbers with this bit set belong to a different ABI sharing the
+    // same token (e.g. x32 on x86_64) and are always rejected.
+    std::uint32_t foreign_abi_bit = 0;
+
+    bool operator==(const Arch& o) const
+    {
+        return token == o.token;
+    }
+};
+
+std::span<const Arch> supported_archs();
+const Arch& native_arch();
+const Arch* find_arch(std::string_view name);
+
+// Returns std::nullopt if the syscall doesn't exist on this arch.
+std::optional<std::uint32_t> resolve_syscall(
+    const Arch& arch, std::string_view name);
+
+// Inverse of resolve_syscall(). Returns an empty string for unknown numbers.
+std::string syscall_name(const Arch& arch, std::uint32_t nr);
+
+} // namespace fekal
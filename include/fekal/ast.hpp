@@ -5,14 +5,30 @@
 
 #include <fekal/ast/programstatement.hpp>
 #include <boost/hana/functional/overload.hpp>
+#include <cstdint>
 #include <memory>
 #include <vector>
+#include <string>
+#include <map>
 
 namespace fekal {
 
 namespace hana = boost::hana;
 
-bool eval(const ast::BoolExpr& e);
+// Values of syscall arguments, keyed by parameter name
+using Bindings = std::map<std::string, std::uint64_t, std::less<>>;
+
+// Reference semantics for expressions: unsigned 64-bit integers with
+// wrap-around arithmetic. Shifts by 64 or more and division by zero yield 0.
+// Unbound identifiers take the value of the symbolic constant of the same name
+// (see constants.hpp), or 0 if there's none.
+std::uint64_t eval(const ast::IntExpr& e, const Bindings& bindings = {});
+bool eval(const ast::BoolExpr& e, const Bindings& bindings = {});
+
+// Structural equality. Unlike operator==, source positions are ignored.
+// Constant time for expressions interned through the same ExprTable.
+bool equivalent(const ast::IntExpr& a, const ast::IntExpr& b);
+bool equivalent(const ast::BoolExpr& a, const ast::BoolExpr& b);
 
 template<class Derived>
 struct Traverser
@@ -59,8 +75,15 @@ struct Traverser
         return traverse_children(node, node.filters);
     }
 
+    // Derived classes may define `bool skip_body(const ast::Policy&)` to visit
+    // a policy without descending into its body
     bool traverse(const ast::Policy& node)
     {
+        if constexpr (requires(Derived& d) { d.skip_body(node); }) {
+            if (derived().skip_body(node)) {
+                return visit_enter_impl(node) && visit_leave_impl(node);
+            }
+        }
         return traverse_children(node, node.body);
     }
 
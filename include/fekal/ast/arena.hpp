@@ -0,0 +1,132 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <memory_resource>
+#include <type_traits>
+#include <stdexcept>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+
+namespace fekal::ast {
+
+// Owns expression nodes. Nodes are carved out of large chunks, reference
+// their children through raw pointers and are released all at once with the
+// arena, so they must be trivially destructible.
+//
+// Nodes may point into other arenas (e.g. a folded guard keeps the untouched
+// subtrees of the parsed one), and an arena keeps those alive as well (see
+// share()). Passes build into an arena newer than the ones they read from, so
+// arenas never keep each other alive in a cycle.
+class Arena : public std::enable_shared_from_this<Arena>
+{
+public:
+    explicit Arena(std::size_t initial_size = 4096)
+        : buffer{initial_size}
+    {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template<class T, class... Args>
+    T* make(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+        return ::new (buffer.allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+    }
+
+    // Keeps the arena that owns `handle` alive for as long as this one
+    void retain(std::shared_ptr<const void> handle)
+    {
+        auto same = [&](const auto& o) {
+            return !handle.owner_before(o) && !o.owner_before(handle);
+        };
+        if (same(weak_from_this()) ||
+            (!retained.empty() && same(retained.back()))) {
+            return;
+        }
+        retained.push_back(std::move(handle));
+    }
+
+private:
+    std::pmr::monotonic_buffer_resource buffer;
+    std::vector<std::shared_ptr<const void>> retained;
+};
+
+inline std::shared_ptr<Arena>*& current_arena()
+{
+    static thread_local std::shared_ptr<Arena>* arena = nullptr;
+    return arena;
+}
+
+// While alive, nodes created by make_int_expr() and make_bool_expr() on this
+// thread are allocated from its arena: a fresh one, or `arena` to add to an
+// existing one. Scopes nest.
+class ArenaScope
+{
+public:
+    explicit ArenaScope(std::size_t initial_size = 4096)
+        : ArenaScope{std::make_shared<Arena>(initial_size)}
+    {}
+
+    explicit ArenaScope(std::shared_ptr<Arena> arena)
+        : arena{std::move(arena)}
+        , previous{current_arena()}
+    {
+        current_arena() = &this->arena;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope()
+    {
+        current_arena() = previous;
+    }
+
+private:
+    std::shared_ptr<Arena> arena;
+    std::shared_ptr<Arena>* previous;
+};
+
+// The arena of the innermost scope
+inline const std::shared_ptr<Arena>& scope_arena()
+{
+    if (auto arena = current_arena() ; arena) {
+        return *arena;
+    }
+    throw std::logic_error{"AST node built outside of an ast::ArenaScope"};
+}
+
+template<class T, class... Args>
+inline T* make_node(Args&&... args)
+{
+    return scope_arena()->make<T>(std::forward<Args>(args)...);
+}
+
+// Handle to `node`, built in the current arena, that keeps the arena alive
+template<class T>
+inline std::shared_ptr<T> share(T* node)
+{
+    return {scope_arena(), node};
+}
+
+// Handle to `node`, the result of rewriting `from`. That's `from` itself if
+// nothing changed. Otherwise `node` belongs to the current arena (or to one
+// it keeps alive), which then keeps the nodes of `from` alive too.
+template<class T>
+inline std::shared_ptr<T> share(T* node, const std::shared_ptr<T>& from)
+{
+    if (node == from.get()) {
+        return from;
+    }
+    const auto& a = scope_arena();
+    a->retain(from);
+    return {a, node};
+}
+
+} // namespace fekal::ast
@@ -5,17 +5,15 @@
 
 #include <fekal/ast/nodebase.hpp>
 #include <fekal/ast/fwd/intexpr.hpp>
-#include <memory>
 
 namespace fekal::ast {
 
 struct BitAndExpr : NodeBase
 {
-    BitAndExpr(unsigned line, unsigned column, std::shared_ptr<IntExpr> left,
-               std::shared_ptr<IntExpr> right)
+    BitAndExpr(unsigned line, unsigned column, IntExpr* left, IntExpr* right)
         : NodeBase{line, column}
-        , left{std::move(left)}
-        , right{std::move(right)}
+        , left{left}
+        , right{right}
     {}
 
     const NodeBase& base() const { return *this; }
@@ -23,7 +21,8 @@ struct BitAndExpr : NodeBase
 
     bool operator==(const BitAndExpr&) const;
 
-    std::shared_ptr<IntExpr> left, right;
+    IntExpr* left;
+    IntExpr* right;
 };
 
 } // namespace fekal::ast
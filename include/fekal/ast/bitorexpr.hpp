@@ -5,17 +5,15 @@
 
 #include <fekal/ast/nodebase.hpp>
 #include <fekal/ast/fwd/intexpr.hpp>
-#include <memory>
 
 namespace fekal::ast {
 
 struct BitOrExpr : NodeBase
 {
-    BitOrExpr(unsigned line, unsigned column, std::shared_ptr<IntExpr> left,
-              std::shared_ptr<IntExpr> right)
+    BitOrExpr(unsigned line, unsigned column, IntExpr* left, IntExpr* right)
         : NodeBase{line, column}
-        , left{std::move(left)}
-        , right{std::move(right)}
+        , left{left}
+        , right{right}
     {}
 
     const NodeBase& base() const { return *this; }
@@ -23,7 +21,8 @@ struct BitOrExpr : NodeBase
 
     bool operator==(const BitOrExpr&) const;
 
-    std::shared_ptr<IntExpr> left, right;
+    IntExpr* left;
+    IntExpr* right;
 };
 
 } // namespace fekal::ast
@@ -7,6 +7,7 @@
 
 #include <boost/mp11/algorithm.hpp>
 
+#include <fekal/ast/arena.hpp>
 #include <fekal/ast/eqexpr.hpp>
 #include <fekal/ast/neqexpr.hpp>
 #include <fekal/ast/ltexpr.hpp>
@@ -22,11 +23,11 @@ namespace fekal::ast {
 template<class T>
 static constexpr bool IsBoolExpr = boost::mp11::mp_contains<BoolExpr, T>::value;
 
+// Built in the arena of the innermost ArenaScope
 template<class E, class... Args>
-inline std::shared_ptr<BoolExpr> make_bool_expr(
-    unsigned line, unsigned column, Args&&... args)
+inline BoolExpr* make_bool_expr(unsigned line, unsigned column, Args&&... args)
 {
-    return std::make_shared<BoolExpr>(
+    return make_node<BoolExpr>(
         std::in_place_type<E>, line, column, std::forward<Args>(args)...);
 }
 
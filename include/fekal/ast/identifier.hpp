@@ -3,20 +3,24 @@
 
 #pragma once
 
-#include <string>
+#include <string_view>
 
 #include <fekal/ast/nodebase.hpp>
+#include <fekal/symbols.hpp>
 
 namespace fekal::ast {
 
 struct Identifier : NodeBase
 {
-    Identifier(unsigned line, unsigned column, std::string value)
+    Identifier(unsigned line, unsigned column, std::string_view value)
         : NodeBase{line, column}
-        , value{std::move(value)}
+        , value{value}
+        , symbol{intern(value)}
     {}
 
-    std::string value;
+    // References the source text (see SourceFile)
+    std::string_view value;
+    SymbolId symbol;
 
     bool operator==(const Identifier&) const = default;
 };
@@ -7,6 +7,7 @@
 
 #include <boost/mp11/algorithm.hpp>
 
+#include <fekal/ast/arena.hpp>
 #include <fekal/ast/intlit.hpp>
 #include <fekal/ast/identifier.hpp>
 #include <fekal/ast/sumexpr.hpp>
@@ -24,11 +25,11 @@ namespace fekal::ast {
 template<class T>
 static constexpr bool IsIntExpr = boost::mp11::mp_contains<IntExpr, T>::value;
 
+// Built in the arena of the innermost ArenaScope
 template<class E, class... Args>
-inline std::shared_ptr<IntExpr> make_int_expr(
-    unsigned line, unsigned column, Args&&... args)
+inline IntExpr* make_int_expr(unsigned line, unsigned column, Args&&... args)
 {
-    return std::make_shared<IntExpr>(
+    return make_node<IntExpr>(
         std::in_place_type<E>, line, column, std::forward<Args>(args)...);
 }
 
@@ -5,17 +5,15 @@
 
 #include <fekal/ast/nodebase.hpp>
 #include <fekal/ast/intexpr.hpp>
-#include <memory>
 
 namespace fekal::ast {
 
 struct LteExpr : NodeBase
 {
-    LteExpr(unsigned line, unsigned column, std::shared_ptr<IntExpr> left,
-            std::shared_ptr<IntExpr> right)
+    LteExpr(unsigned line, unsigned column, IntExpr* left, IntExpr* right)
         : NodeBase{line, column}
-        , left{std::move(left)}
-        , right{std::move(right)}
+        , left{left}
+        , right{right}
     {}
 
     const NodeBase& base() const { return *this; }
@@ -23,7 +21,8 @@ struct LteExpr : NodeBase
 
     bool operator==(const LteExpr&) const;
 
-    std::shared_ptr<IntExpr> left, right;
+    IntExpr* left;
+    IntExpr* right;
 };
 
 } // namespace fekal::ast
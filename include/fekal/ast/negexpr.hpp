@@ -5,15 +5,14 @@
 
 #include <fekal/ast/nodebase.hpp>
 #include <fekal/ast/fwd/boolexpr.hpp>
-#include <memory>
 
 namespace fekal::ast {
 
 struct NegExpr : NodeBase
 {
-    NegExpr(unsigned line, unsigned column, std::shared_ptr<BoolExpr> inner)
+    NegExpr(unsigned line, unsigned column, BoolExpr* inner)
         : NodeBase{line, column}
-        , inner{std::move(inner)}
+        , inner{inner}
     {}
 
     const NodeBase& base() const { return *this; }
@@ -21,7 +20,7 @@ struct NegExpr : NodeBase
 
     bool operator==(const NegExpr&) const;
 
-    std::shared_ptr<BoolExpr> inner;
+    BoolExpr* inner;
 };
 
 } // namespace fekal::ast
@@ -5,17 +5,15 @@
 
 #include <fekal/ast/nodebase.hpp>
 #include <fekal/ast/fwd/boolexpr.hpp>
-#include <memory>
 
 namespace fekal::ast {
 
 struct OrExpr : NodeBase
 {
-    OrExpr(unsigned line, unsigned column, std::shared_ptr<BoolExpr> left,
-           std::shared_ptr<BoolExpr> right)
+    OrExpr(unsigned line, unsigned column, BoolExpr* left, BoolExpr* right)
         : NodeBase{line, column}
-        , left{std::move(left)}
-        , right{std::move(right)}
+        , left{left}
+        , right{right}
     {}
 
     const NodeBase& base() const { return *this; }
@@ -23,7 +21,8 @@ struct OrExpr : NodeBase
 
     bool operator==(const OrExpr&) const;
 
-    std::shared_ptr<BoolExpr> left, right;
+    BoolExpr* left;
+    BoolExpr* right;
 };
 
 } // namespace fekal::ast
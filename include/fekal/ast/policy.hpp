@@ -11,23 +11,27 @@ struct Policy : NodeBase
 {
     Policy(unsigned line,
            unsigned column,
-           std::string name,
-           std::string version,
+           std::string_view name,
+           std::string_view version,
            std::vector<PolicyStatement> body)
         : NodeBase{line, column}
-        , name{std::move(name)}
-        , version{std::move(version)}
+        , name{name}
+        , version{version}
+        , name_symbol{intern(name)}
+        , version_symbol{intern(version)}
         , body{std::move(body)}
     {}
 
-    std::string name;
-    std::string version;
+    std::string_view name;
+    std::string_view version;
+    SymbolId name_symbol;
+    SymbolId version_symbol;
     std::vector<PolicyStatement> body;
 
     bool operator==(const Policy&) const = default;
 
-    std::string id() const {
-        return name + version;
+    SymbolKey key() const {
+        return symbol_key(name_symbol, version_symbol);
     }
 };
 
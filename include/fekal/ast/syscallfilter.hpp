@@ -13,24 +13,30 @@ using SyscallParameters = std::vector<ast::Identifier>;
 
 struct SyscallFilter : NodeBase
 {
-    SyscallFilter(unsigned line, unsigned column, std::string syscall)
+    SyscallFilter(unsigned line, unsigned column, std::string_view syscall)
         : NodeBase{line, column}
-        , syscall{std::move(syscall)} {}
+        , syscall{syscall}
+        , symbol{intern(syscall)}
+    {}
 
     SyscallFilter(
         unsigned line,
         unsigned column,
-        std::string syscall,
+        std::string_view syscall,
         SyscallParameters params,
         std::vector<std::shared_ptr<BoolExpr>> body)
         : NodeBase{line, column}
-        , syscall{std::move(syscall)}
+        , syscall{syscall}
+        , symbol{intern(syscall)}
         , params{std::move(params)}
         , body{std::move(body)}
     {}
 
-    std::string syscall;
+    std::string_view syscall;
+    SymbolId symbol;
     SyscallParameters params;
+
+    // Each handle keeps the arena of its expression alive (see share())
     std::vector<std::shared_ptr<BoolExpr>> body;
 
     bool operator==(const SyscallFilter& o) const {
@@ -4,26 +4,31 @@
 #pragma once
 
 #include <fekal/ast/nodebase.hpp>
-#include <string>
+#include <fekal/symbols.hpp>
+#include <string_view>
 
 namespace fekal::ast {
 
 struct UseStatement : NodeBase
 {
-    UseStatement(unsigned line, unsigned column, std::string policy,
-            std::string version)
+    UseStatement(unsigned line, unsigned column, std::string_view policy,
+            std::string_view version)
         : NodeBase{line, column}
-        , policy{std::move(policy)}
-        , version{std::move(version)}
+        , policy{policy}
+        , version{version}
+        , policy_symbol{intern(policy)}
+        , version_symbol{intern(version)}
     {}
 
     bool operator==(const UseStatement&) const = default;
 
-    std::string policy;
-    std::string version;
+    std::string_view policy;
+    std::string_view version;
+    SymbolId policy_symbol;
+    SymbolId version_symbol;
 
-    std::string id() const {
-        return policy + version;
+    SymbolKey key() const {
+        return symbol_key(policy_symbol, version_symbol);
     }
 };
 
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+
+namespace fekal::bpf {
+
+// Classic BPF as accepted by SECCOMP_SET_MODE_FILTER.
+using Program = std::vector<sock_filter>;
+
+struct Result
+{
+    std::uint32_t action;
+
+    // Amount of instructions executed to reach the return (inclusive).
+    unsigned executed;
+};
+
+// Runs the program in userspace mimicking the kernel's semantics. Throws on
+// programs the kernel would refuse to load (e.g. out-of-bounds loads).
+Result emulate(std::span<const sock_filter> program, const seccomp_data& data);
+
+// Greatest amount of instructions the syscall might execute for any value of
+// its arguments. Only the loads of seccomp_data::arch and seccomp_data::nr are
+// assumed to be known, so infeasible paths might be accounted for.
+unsigned worst_case_path(
+    std::span<const sock_filter> program, std::uint32_t arch,
+    std::uint32_t nr);
+
+// Retargets jumps past unconditional jumps and past tests whose outcome is
+// already known. Unconditional jumps to a return become the return itself.
+void thread_jumps(Program& program);
+
+// Removes unreachable instructions and jumps to the next instruction.
+void eliminate_dead_code(Program& program);
+
+} // namespace fekal::bpf
@@ -23,9 +23,7 @@ struct Checker : public Traverser<Checker>
         auto& scope = context.peek_scope();
         std::visit(hana::overload(
             [&](const ast::Identifier& identifier) {
-                if (scope.has_symbol(identifier.value)) {
-                    scope.increase_reference(identifier.value);
-                }
+                scope.increase_reference(symbol_key(identifier.symbol));
             },
             [&](const auto& expr) {}
         ), expr);
@@ -34,26 +32,27 @@ struct Checker : public Traverser<Checker>
     void visit(const ast::SyscallFilter& filter)
     {
         auto& scope = context.peek_scope();
-        if (scope.has_symbol(filter.syscall)) {
+        if (scope.has_symbol(symbol_key(filter.symbol))) {
             diagnostics.error(
                 std::format("Syscall filter `{}` already declared in this scope", filter.syscall),
                 diagnostics.rangeFromName(filter, filter.syscall)
             );
         }
 
-        scope.declare_symbol(Symbol{filter.syscall});
+        scope.declare_symbol(
+            Symbol{symbol_key(filter.symbol), filter.syscall});
 
         if (filter.params.size() > 0) {
             auto& scope = context.push_scope(filter);
             for (const auto& p : filter.params) {
-                if (scope.has_symbol(p.value)) {
+                if (scope.has_symbol(symbol_key(p.symbol))) {
                     diagnostics.error(
                         std::format("syscall parameter {} already declared", p.value),
                         diagnostics.rangeFromName(p, p.value)
                     );
                     continue;
                 }
-                scope.declare_symbol(Symbol{p.value});
+                scope.declare_symbol(Symbol{symbol_key(p.symbol), p.value});
             }
         }
     }
@@ -63,7 +62,7 @@ struct Checker : public Traverser<Checker>
         if (filter.params.size() > 0) {
             auto& scope = context.peek_scope();
             for (const auto& p : std::views::reverse(filter.params)) {
-                auto symbol = scope.get_symbol(p.value);
+                auto symbol = scope.get_symbol(symbol_key(p.symbol));
                 if (symbol.references == 0) {
                     diagnostics.warning(
                         std::format("Parameter {} unused", symbol.name),
@@ -79,9 +78,10 @@ struct Checker : public Traverser<Checker>
 
     void visit(const ast::UseStatement& stmt)
     {
-        if (!context.has_symbol(stmt.id())) {
+        if (!context.has_symbol(stmt.key())) {
             diagnostics.error(
-                std::format("Policy {} doesn't exist", stmt.id()),
+                std::format(
+                    "Policy {} {} doesn't exist", stmt.policy, stmt.version),
                 diagnostics.rangeFromName(stmt, stmt.policy)
             );
         }
@@ -100,13 +100,15 @@ struct Checker : public Traverser<Checker>
     void visit(const ast::Policy& policy)
     {
         auto& scope = context.peek_scope();
-        if (scope.has_symbol(policy.id())) {
+        if (scope.has_symbol(policy.key())) {
             diagnostics.error(
-                std::format("policy {} already declared", policy.id()),
+                std::format(
+                    "policy {} {} already declared", policy.name,
+                    policy.version),
                 diagnostics.rangeFromName(policy, policy.name)
             );
         }
-        scope.declare_symbol(Symbol(policy.id()));
+        scope.declare_symbol(Symbol{policy.key(), policy.name});
         context.push_scope(policy);
     }
 
@@ -115,6 +117,11 @@ struct Checker : public Traverser<Checker>
         context.pop_scope();
     }
 
+    bool skip_body(const ast::Policy& policy)
+    {
+        return !context.is_reachable(policy);
+    }
+
 private:
     Context& context;
     Diagnostics& diagnostics;
@@ -6,74 +6,93 @@
 #include <fekal/checker/scope.hpp>
 #include <fekal/ast.hpp>
 #include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+#include <deque>
 
 namespace fekal {
 
+// Scopes form a tree: each one links to its parent, so walking up needs no
+// lookup. The scope a node opened is found through the node's address, which
+// only the context records: the AST is left untouched, so it may be checked
+// again after reset() or by another context. Scopes stay in place until
+// reset() and are never moved, so references to them remain valid.
 struct Context
 {
-    unsigned scopeIndex = 0;
+    // Policies no USE from the top level reaches. Their bodies are skipped
+    // by the checker and by rule passes.
+    std::unordered_set<const ast::Policy*> unreachable;
 
-    void reset()
+    bool is_reachable(const ast::Policy& policy) const
     {
-        scopeIndex = 0;
-        nodeScopes.clear();
-        scopes.clear();
-        scopes.push_back(std::make_shared<Scope>());
+        return !unreachable.contains(&policy);
     }
 
-    Scope& get_scope()
+    void reset()
     {
-        return *scopes.at(scopeIndex);
+        unreachable.clear();
+        node_scopes.clear();
+        scopes.clear();
+        scopes.emplace_back();
+        current = 0;
     }
 
     Scope& global_scope()
     {
-        return *scopes.at(0);
+        return scopes.front();
     }
 
     template<class Node>
     Scope& push_scope(const Node& node)
     {
-        auto scope = std::make_shared<Scope>();
-        scopes.emplace_back(scope);
-        nodeScopes[&node] = scope;
-        scopeIndex++;
-        return *scopes.back();
+        unsigned index = scopes.size();
+        node_scopes[&node] = index;
+        auto& scope = scopes.emplace_back();
+        scope.parent = current;
+        current = index;
+        return scope;
     }
 
     template<class Node>
     Scope& get_scope_by_node(const Node& node)
     {
-        return *nodeScopes.at(&node);
+        return scopes.at(node_scopes.at(&node));
     }
 
-    bool has_symbol(const std::string& symbol)
+    // Looks into the current scope and its ancestors
+    bool has_symbol(SymbolKey symbol)
     {
-        for (int i = scopeIndex; i >= 0; i--) {
-            if (scopes.at(i)->has_symbol(symbol)) {
+        for (auto i = current ;; i = scopes[i].parent) {
+            if (scopes[i].has_symbol(symbol)) {
                 return true;
             }
+            if (i == 0) {
+                return false;
+            }
         }
-        return false;
     }
 
     void pop_scope()
     {
-        if (scopeIndex == 0) {
+        if (current == 0) {
             throw std::runtime_error("Not allowed to erase global scope");
         }
-        scopes.erase(scopes.begin() + scopeIndex);
-        scopeIndex--;
+        current = scopes[current].parent;
     }
 
-    Scope& peek_scope() const
+    Scope& peek_scope()
     {
-        return *scopes.at(scopeIndex);
+        return scopes[current];
     }
 
+    Context() = default;
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+
 private:
-    std::vector<std::shared_ptr<Scope>> scopes {std::make_shared<Scope>()};
-    std::unordered_map<const void*, std::shared_ptr<Scope>> nodeScopes {};
+    std::deque<Scope> scopes{1};
+    std::unordered_map<const void*, unsigned> node_scopes;
+    unsigned current = 0;
 };
 
 } // namespace fekal
@@ -0,0 +1,54 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/ast.hpp>
+#include <fekal/diagnostics.hpp>
+#include <fekal/checker/context.hpp>
+#include <unordered_map>
+#include <string_view>
+#include <functional>
+#include <vector>
+
+namespace fekal {
+
+// Check specific to the filters of some syscalls. Rules may run concurrently
+// on different filters, so they must only modify the scope of the filter they
+// are given.
+struct SyscallRule
+{
+    std::vector<std::string_view> syscalls;
+    std::function<void(Context&, Diagnostics&, const ast::SyscallFilter&)>
+        check;
+};
+
+// Rules keyed by syscall. check() walks the program once and hands each filter
+// only to the rules registered for its syscall. Bodies of unreachable
+// policies are skipped.
+//
+// Filters are checked on up to `jobs` threads (0 for one per core), each one
+// logging to its own buffer. The buffers are merged in program order and the
+// merged logs sorted by source position, so the output doesn't depend on the
+// number of threads.
+class RuleSet
+{
+public:
+    // The rule must outlive the set
+    void add(const SyscallRule& rule);
+
+    bool empty() const
+    {
+        return rules.empty();
+    }
+
+    void check(
+        Context& context, Diagnostics& diagnostics,
+        const std::vector<ast::ProgramStatement>& ast,
+        unsigned jobs = 1) const;
+
+private:
+    std::unordered_map<SymbolId, std::vector<const SyscallRule*>> rules;
+};
+
+} // namespace fekal
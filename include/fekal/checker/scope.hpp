@@ -6,19 +6,25 @@
 #include <algorithm>
 #include <cstddef>
 #include <fekal/ast.hpp>
+#include <fekal/symbols.hpp>
 #include <iterator>
-#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace fekal {
 
 struct Symbol
 {
-    Symbol(const std::string& name) : name{name} {}
+    Symbol(SymbolKey key, std::string_view name) : key{key}, name{name} {}
+
+    SymbolKey key;
+
+    // For diagnostics
+    std::string_view name;
 
-    std::string name;
     unsigned references = 0;
 
     inline void increase_reference()
@@ -28,25 +34,29 @@ struct Symbol
 
     inline bool is_blank() const
     {
-        return name == "_";
+        return key == symbol_key(blank_symbol);
     }
 };
 
 struct Scope
 {
-    bool has_symbol(const std::string& id) const
+    // Index of the enclosing scope in Context. The global scope is its own
+    // parent.
+    unsigned parent = 0;
+
+    bool has_symbol(SymbolKey key) const
     {
-        return id != "_" && (symbols.contains(id) || inheritSymbols.contains(id));
+        return key != symbol_key(blank_symbol) &&
+            (symbols.contains(key) || inheritSymbols.contains(key));
     }
 
     bool declare_symbol(const Symbol& symbol)
     {
-        if (!symbols.contains(symbol.name)) {
-            auto symbol_ptr = std::make_shared<Symbol>(symbol);
+        if (!symbols.contains(symbol.key)) {
             if (!symbol.is_blank()) {
-                symbols.insert(std::make_pair(symbol.name, symbol_ptr));
+                symbols.emplace(symbol.key, symbolsOrder.size());
             }
-            symbolsOrder.emplace_back(symbol_ptr);
+            symbolsOrder.push_back(symbol);
             return true;
         }
         return false;
@@ -54,12 +64,7 @@ struct Scope
 
     bool declare_inherit_symbol(const Symbol& symbol)
     {
-        if (!inheritSymbols.contains(symbol.name)) {
-            auto symbol_ptr = std::make_shared<Symbol>(symbol);
-            inheritSymbols.insert(std::make_pair(symbol.name, symbol_ptr));
-            return true;
-        }
-        return false;
+        return inheritSymbols.insert(symbol.key).second;
     }
 
     size_t num_symbols()
@@ -67,39 +72,38 @@ struct Scope
         return symbolsOrder.size();
     }
 
-    Symbol& get_symbol(const std::string& name)
+    Symbol& get_symbol(SymbolKey key)
     {
-        if (symbols.contains(name)) {
-            return *symbols.at(name).get();
+        if (auto it = symbols.find(key) ; it != symbols.end()) {
+            return symbolsOrder[it->second];
         }
         throw std::runtime_error("Symbol not found");
     }
 
-    std::optional<unsigned> get_symbol_position(const std::string& name) const
+    std::optional<unsigned> get_symbol_position(SymbolKey key) const
     {
-        auto it = std::find_if(
-            symbolsOrder.begin(),
-            symbolsOrder.end(),
-            [&name](const std::shared_ptr<Symbol>& symbol) {
-                return symbol->name == name;
-            });
+        auto it = std::ranges::find(symbolsOrder, key, &Symbol::key);
         if (it == symbolsOrder.cend()) {
             return std::nullopt;
         }
         return std::distance(symbolsOrder.begin(), it);
     }
 
-    void increase_reference(std::string name)
+    void increase_reference(SymbolKey key)
     {
-        if (has_symbol(name)) {
-            symbols.at(name)->increase_reference();
+        if (auto it = symbols.find(key) ; it != symbols.end()) {
+            symbolsOrder[it->second].increase_reference();
         }
     }
 
     private:
-        std::vector<std::shared_ptr<Symbol>> symbolsOrder;
-        std::unordered_map<std::string, std::shared_ptr<Symbol>> symbols;
-        std::unordered_map<std::string, std::shared_ptr<Symbol>> inheritSymbols;
+        // Declaration order
+        std::vector<Symbol> symbolsOrder;
+
+        // Indexes into symbolsOrder
+        std::unordered_map<SymbolKey, unsigned> symbols;
+
+        std::unordered_set<SymbolKey> inheritSymbols;
 };
 
 } // namespace fekal
@@ -6,44 +6,14 @@
 #include <fekal/ast/identifier.hpp>
 #include <fekal/ast.hpp>
 #include <fekal/checker.hpp>
-#include <boost/algorithm/string.hpp>
-#include <boost/describe/enum.hpp>
-#include <boost/describe/enum_to_string.hpp>
+#include <fekal/constants.hpp>
 #include <optional>
 
 namespace fekal::rules {
 
-namespace mp11 = boost::mp11;
-
-BOOST_DEFINE_ENUM_CLASS(
-    OFLAGS,
-
-    o_async,
-    o_direct,
-    o_dsync,
-    o_largefile,
-    o_noatime,
-    o_noctty,
-    o_path,
-    o_sync,
-    o_tmpfile,
-    o_rdonly,
-    o_wronly,
-    o_rdwr,
-    o_nonblock,
-    o_append,
-    o_creat,
-    o_trunc,
-    o_excl,
-    o_directory,
-    o_nofollow,
-    o_cloexec,
-);
-
-
 struct SyscallOpen : Traverser<SyscallOpen>
 {
-    SyscallOpen(Context context, Diagnostics& diagnostics)
+    SyscallOpen(Context& context, Diagnostics& diagnostics)
         : context{context}
         , diagnostics{diagnostics}
     {}
@@ -56,7 +26,7 @@ struct SyscallOpen : Traverser<SyscallOpen>
             [](const ast::Identifier&) {},
             [](const ast::IntLit&) {},
             [&](const auto& expr) {
-                check_expr(expr.left.get(), expr.right.get());
+                check_expr(expr.left, expr.right);
             }
         ), expr);
     }
@@ -68,15 +38,16 @@ struct SyscallOpen : Traverser<SyscallOpen>
             [](const ast::AndExpr&) {},
             [](const ast::OrExpr&) {},
             [&](const auto& expr) {
-                check_expr(expr.left.get(), expr.right.get());
+                check_expr(expr.left, expr.right);
             }
         ), expr);
     }
 
-    bool visit(const ast::SyscallFilter& filter)
+    // Called by RuleSet for the filters of `syscalls`
+    void check(const ast::SyscallFilter& filter)
     {
-        if (!std::find(syscalls.begin(), syscalls.end(), filter.syscall) || filter.params.size() < 2) {
-            return false;
+        if (filter.params.size() < 2) {
+            return;
         }
 
         oflag_index = 1;
@@ -87,26 +58,19 @@ struct SyscallOpen : Traverser<SyscallOpen>
 
         auto& scope = context.get_scope_by_node(filter);
 
-        mp11::mp_for_each<boost::describe::describe_enumerators<OFLAGS>>([&](auto flag) {
-            std::string name = boost::to_upper_copy(
-                std::string(boost::describe::enum_to_string(flag.value, "")),
-                std::locale::classic()
-            );
-            scope.declare_inherit_symbol(Symbol{name});
-        });
+        for (const auto& c : constants()) {
+            if (c.name.starts_with("O_")) {
+                scope.declare_inherit_symbol(
+                    Symbol{symbol_key(intern(c.name)), c.name});
+            }
+        }
 
         filter_scope = scope;
-
-        return true;
-    }
-
-    void check(const std::vector<ast::ProgramStatement>& ast)
-    {
-        traverse(ast);
+        traverse(filter.body);
     }
 
 private:
-    Context context;
+    Context& context;
     Diagnostics& diagnostics;
     std::optional<std::reference_wrapper<Scope>> filter_scope;
     unsigned oflag_index = 1;
@@ -131,14 +95,15 @@ private:
     template<class Other>
     void check_expr_value(const ast::Identifier& identifier, const Other& other, const Scope& scope)
     {
-        const auto& symbol_position = scope.get_symbol_position(identifier.value);
+        const auto& symbol_position = scope.get_symbol_position(
+            symbol_key(identifier.symbol));
         if (symbol_position.has_value()) {
             if (symbol_position.value() != oflag_index) {
                 return;
             }
             std::visit(hana::overload(
                 [&](const ast::Identifier& identifier) {
-                    if (!scope.has_symbol(identifier.value)) {
+                    if (!scope.has_symbol(symbol_key(identifier.symbol))) {
                         diagnostics.error(
                             std::format("Invalid oflag {}", identifier.value),
                             diagnostics.rangeFromName(identifier, identifier.value)
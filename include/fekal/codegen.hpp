@@ -0,0 +1,72 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/ast.hpp>
+#include <fekal/arch.hpp>
+#include <fekal/bpf.hpp>
+#include <fekal/diagnostics.hpp>
+#include <fekal/ir.hpp>
+#include <span>
+
+namespace fekal {
+
+struct CodegenOptions
+{
+    // Dispatch on the syscall number with a binary search instead of a linear
+    // chain of comparisons.
+    bool binary_dispatch = false;
+
+    // Check runs of consecutive syscall numbers sharing the same code as a
+    // single range.
+    bool coalesce_ranges = false;
+};
+
+// Flattens the program into a decision table for the given archs, reporting
+// whatever can't be lowered.
+//
+// Semantics:
+//
+// - Only top-level action blocks and USE statements contribute rules. POLICY
+//   blocks alone are just definitions.
+// - If several rules match a syscall, the action with the greatest precedence
+//   wins. Precedence follows the kernel's when stacking filters
+//   (KILL_PROCESS > KILL_THREAD > TRAP > ERRNO > USER_NOTIF > TRACE > LOG >
+//   ALLOW).
+// - Each expression in a syscall filter body is an alternative. An empty body
+//   matches unconditionally.
+// - Expressions follow the reference semantics of `eval()`, with each
+//   parameter bound to its syscall argument. 32-bit archs zero-extend
+//   arguments.
+// - Syscalls matching no rule get the DEFAULT action (KILL_PROCESS if
+//   absent).
+ir::DecisionTable lower(
+    Diagnostics& diagnostics,
+    const std::vector<ast::ProgramStatement>& ast,
+    std::span<const Arch> archs);
+
+// Removes rules that can never decide the outcome and reports each dropped
+// rule as a hint:
+//
+// - rules after an unconditional one;
+// - rules whose every alternative already appears in an earlier rule;
+// - conditional rules right before an unconditional one with the same action.
+//
+// Consecutive conditional rules with the same action are merged into a
+// single disjunction.
+void eliminate_redundant_rules(
+    Diagnostics& diagnostics, ir::DecisionTable& table);
+
+// Drops entries shadowed by an unconditional entry and syscalls whose only
+// outcome is the default action.
+void prune_rules(ir::DecisionTable& table);
+
+// Emits a seccomp filter for the table. Returns an empty program if the result
+// is too large for the kernel.
+bpf::Program emit(
+    Diagnostics& diagnostics,
+    const ir::DecisionTable& table,
+    const CodegenOptions& options = {});
+
+} // namespace fekal
@@ -5,8 +5,11 @@
 
 #include <vector>
 #include <fekal/ast.hpp>
+#include <fekal/arch.hpp>
+#include <fekal/bpf.hpp>
 #include <fekal/checker.hpp>
 #include <fekal/diagnostics.hpp>
+#include <fekal/passes.hpp>
 
 namespace fekal {
 
@@ -14,6 +17,11 @@ struct Compiler
 {
     Context context;
     Diagnostics diagnostics;
+    PassManager passes;
+
+    // Policies that no top-level USE reaches are skipped by the checker and by
+    // rule passes unless set. Meant for CI over policy libraries.
+    bool check_all = false;
 
     Compiler();
     Compiler(bool stdout_has_colors) : diagnostics(stdout_has_colors) {};
@@ -21,7 +29,10 @@ struct Compiler
     void reset();
     void print_errors();
     std::vector<ast::ProgramStatement> compile(const std::string_view source);
-    void compile_rules(const std::vector<ast::ProgramStatement>& source);
+    void compile_rules(std::vector<ast::ProgramStatement>& source);
+    bpf::Program codegen(
+        const std::vector<ast::ProgramStatement>& ast,
+        std::span<const Arch> archs);
 };
 
 } // namespace fekal
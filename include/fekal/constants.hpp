@@ -0,0 +1,61 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/ast.hpp>
+#include <fekal/arch.hpp>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <vector>
+#include <span>
+
+namespace fekal {
+
+struct Constant
+{
+    std::string_view name;
+    std::uint64_t value;
+};
+
+// Symbolic constants accepted in expressions: O_*, AF_*, SOCK_*, personality
+// values (PER_* and their flags) and CLONE_*. Sorted by name.
+//
+// Values follow the kernel's generic ABI (x86, riscv, ...). arm and arm64 have
+// their own values for a few open() flags (O_DIRECTORY, O_NOFOLLOW, O_DIRECT,
+// O_LARGEFILE and O_TMPFILE), which find_constant() gives for those archs.
+std::span<const Constant> constants();
+
+// Generic value of `name`
+std::optional<std::uint64_t> find_constant(std::string_view name);
+
+// Value of `name` on `arch`
+std::optional<std::uint64_t> find_constant(
+    std::string_view name, const Arch& arch);
+
+// Whether some supported arch has its own value for `name`
+bool depends_on_arch(std::string_view name);
+
+// Values of errno names (EPERM, ...) for ERRNO()
+std::optional<std::uint32_t> find_errno(std::string_view name);
+
+// Replaces symbolic constants and every subexpression without syscall
+// parameters in the body of `filter` by its value. Parameters shadow
+// constants of the same name. Kept for lowering to report:
+//
+// - unknown identifiers;
+// - divisions whose divisor folds to 0.
+//
+// Nodes aren't modified. Subtrees that fold are rebuilt, and the rest stay
+// shared with other copies of the filter, which keep their expressions as
+// written. Rebuilt nodes go to the current arena, or to a fresh one if no
+// ast::ArenaScope is open.
+//
+// Constants that depend on the arch are only folded when `arch` is given.
+void fold_constants(ast::SyscallFilter& filter, const Arch* arch = nullptr);
+
+// Folds every syscall filter of `ast`
+void fold_constants(std::vector<ast::ProgramStatement>& ast);
+
+} // namespace fekal
@@ -9,6 +9,9 @@
 #include <ostream>
 #include <ranges>
 #include <unistd.h>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace fekal {
 
@@ -78,30 +81,51 @@ struct Diagnostics
         logs.push_back(std::move(log));
     }
 
-    void print()
+    void hint(const std::string& msg, Range range)
     {
+        auto log = Log{Severity::Hint, msg, range};
+        logs.push_back(std::move(log));
+    }
+
+    bool has_errors() const
+    {
+        return std::ranges::any_of(logs, [](const auto& log) {
+            return log.severity == Severity::Error;
+        });
+    }
+
+    void print(std::ostream& out = std::cerr)
+    {
+        std::ranges::for_each(
+            logs
+            | std::views::filter([](const auto& log) { return log.severity == Severity::Hint; }),
+            [this, &out](const auto& log) {
+                auto severity = this->stdout_has_colors ? "\033[36mHint:\033[0m " : "Hint ";
+                out << severity << log.message << std::endl;
+            }
+        );
         std::ranges::for_each(
             logs
             | std::views::filter([](const auto& log) { return log.severity == Severity::Warning; })
             | std::views::take(maxWarnings),
-            [this](const auto& log) {
+            [this, &out](const auto& log) {
                 auto severity = this->stdout_has_colors ? "\033[33mWarning:\033[0m " : "Warning ";
-                std::cerr << severity << log.message << std::endl;
+                out << severity << log.message << std::endl;
             }
         );
         std::ranges::for_each(
             logs
             | std::views::filter([](const auto& log) { return log.severity == Severity::Error; })
             | std::views::take(maxErrors),
-            [this](const auto& log) {
+            [this, &out](const auto& log) {
                 auto severity = this->stdout_has_colors ? "\033[31mError:\033[0m " : "Warning ";
-                std::cerr << severity << log.message << std::endl;
+                out << severity << log.message << std::endl;
             }
         );
     }
 
     template<class Node>
-    Range rangeFromName(const Node& node, std::string name) const
+    Range rangeFromName(const Node& node, std::string_view name) const
     {
         return Range{
             .start{node.line, node.column},
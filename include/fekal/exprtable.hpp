@@ -0,0 +1,69 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/ast.hpp>
+#include <unordered_set>
+#include <memory>
+#include <vector>
+
+namespace fekal {
+
+// Hash-consing of expressions. Expressions interned through the same table
+// that are structurally equal (source positions aside) end up as the same
+// node, which keeps the position of the first occurrence. Comparing interned
+// expressions is then a pointer comparison.
+//
+// Children are interned first, so each node only hashes its own operator and
+// the addresses of its children. Nodes aren't modified: one whose children
+// intern to other nodes is copied, so other references to it (e.g. from the
+// AST as parsed) are left alone. Interned nodes are shared and must not be
+// mutated afterwards.
+//
+// Copies are built in the table's arena, which also keeps alive the arenas of
+// every expression interned.
+class ExprTable
+{
+public:
+    ExprTable();
+
+    std::shared_ptr<ast::BoolExpr> intern(
+        const std::shared_ptr<ast::BoolExpr>& expr);
+
+    // Interns the body of every syscall filter
+    void intern(std::vector<ast::ProgramStatement>& ast);
+
+    // Distinct nodes
+    std::size_t size() const
+    {
+        return ints.size() + bools.size();
+    }
+
+    const std::shared_ptr<ast::Arena>& arena() const
+    {
+        return arena_;
+    }
+
+private:
+    ast::IntExpr* intern(ast::IntExpr* expr);
+    ast::BoolExpr* intern(ast::BoolExpr* expr);
+
+    struct Hash
+    {
+        std::size_t operator()(const ast::IntExpr* e) const;
+        std::size_t operator()(const ast::BoolExpr* e) const;
+    };
+
+    struct Equal
+    {
+        bool operator()(const ast::IntExpr* a, const ast::IntExpr* b) const;
+        bool operator()(const ast::BoolExpr* a, const ast::BoolExpr* b) const;
+    };
+
+    std::shared_ptr<ast::Arena> arena_;
+    std::unordered_set<ast::IntExpr*, Hash, Equal> ints;
+    std::unordered_set<ast::BoolExpr*, Hash, Equal> bools;
+};
+
+} // namespace fekal
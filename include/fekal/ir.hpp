@@ -0,0 +1,75 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/ast.hpp>
+#include <fekal/arch.hpp>
+#include <linux/seccomp.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+// Decision tables sit between the AST and BPF. USE statements, action blocks
+// and DEFAULT are already flattened and precedence is already resolved, so
+// passes over this IR never need to walk policies again.
+namespace fekal::ir {
+
+// Argument predicate of an entry. Each entry owns a copy of the filter so
+// passes may rewrite guards without touching the AST (expression nodes are
+// still shared until rewritten). Symbolic constants are already folded, with
+// the values of the arch the entry belongs to. An empty body matches
+// unconditionally.
+using Guard = ast::SyscallFilter;
+
+struct Entry
+{
+    Guard guard;
+
+    // SECCOMP_RET_* value
+    std::uint32_t action;
+
+    // Body as written, for the positions of each occurrence: interned guard
+    // expressions keep the position of the first occurrence in the program.
+    // Cleared by passes that change the shape of the guard.
+    std::vector<std::shared_ptr<ast::BoolExpr>> written = {};
+
+    bool unconditional() const
+    {
+        return guard.body.empty();
+    }
+};
+
+// Entries in the order they are tested. The first matching one wins.
+struct Syscall
+{
+    std::string name;
+    std::vector<Entry> entries;
+};
+
+struct ArchTable
+{
+    Arch arch;
+
+    // Keyed by syscall number
+    std::map<std::uint32_t, Syscall> syscalls;
+};
+
+struct DecisionTable
+{
+    // In dispatch order. Syscalls from other archs kill the process.
+    std::vector<ArchTable> archs;
+
+    // SECCOMP_RET_* value for syscalls absent from the table or matching no
+    // entry
+    std::uint32_t default_action;
+};
+
+std::uint32_t action_value(const ast::Action& action);
+
+// Greater wins. Follows the kernel's ordering when stacking filters, where
+// only the action (and not its data) is compared.
+std::int64_t precedence(std::uint32_t action);
+
+} // namespace fekal::ir
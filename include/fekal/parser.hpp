@@ -5,9 +5,48 @@
 
 #include <fekal/ast.hpp>
 #include <string_view>
+#include <utility>
 
 namespace fekal {
 
-std::vector<ast::ProgramStatement> parse(std::string_view input);
+// Names in the result reference `input` (see SourceFile).
+//
+// Large inputs are split at top-level statements and parsed on up to `jobs`
+// threads (0 for one per core). The result doesn't depend on the number of
+// threads.
+std::vector<ast::ProgramStatement> parse(
+    std::string_view input, unsigned jobs = 1);
+
+// What a parse cost beyond its result, for benchmarks. Memo figures are zero
+// when built with FEKAL_DISABLE_PEG_MEMOIZATION.
+struct ParseStats
+{
+    std::size_t tokens = 0;
+
+    // PEG results memoized, summed over statements
+    std::size_t memo_entries = 0;
+
+    // Peak memory held by the memo store of one statement
+    std::size_t memo_bytes = 0;
+};
+
+// As above, on one thread. `stats` is filled in even if parsing throws.
+std::vector<ast::ProgramStatement> parse(
+    std::string_view input, ParseStats& stats);
+
+// Filter expressions are parsed either by the PEG rules or by precedence
+// climbing, which builds the same trees in linear time. parse() uses the
+// PEG rules unless built with FEKAL_PRECEDENCE_CLIMBING.
+enum class ExpressionParser
+{
+    peg,
+    precedence_climbing,
+};
+
+// Parses the longest filter expression at the start of `input` (nullptr if
+// none) and returns it along with the offset where it stops. Both parsers are
+// always available so they can be checked against each other.
+std::pair<std::shared_ptr<ast::BoolExpr>, std::size_t> parse_expression(
+    std::string_view input, ExpressionParser parser);
 
 } // namespace fekal
@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/ast.hpp>
+#include <fekal/bpf.hpp>
+#include <fekal/codegen.hpp>
+#include <fekal/diagnostics.hpp>
+#include <fekal/checker/context.hpp>
+#include <fekal/checker/rules.hpp>
+#include <unordered_map>
+#include <functional>
+#include <ostream>
+#include <variant>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace fekal {
+
+using AstPass = std::function<void(
+    Context&, Diagnostics&, std::vector<ast::ProgramStatement>&)>;
+using IrPass = std::function<void(Diagnostics&, ir::DecisionTable&)>;
+using BpfPass = std::function<void(bpf::Program&)>;
+
+// Features of the lowering from the IR to BPF are toggled like passes.
+using LoweringOption = bool CodegenOptions::*;
+
+struct Pass
+{
+    std::string name;
+
+    // Lowest optimisation level enabling the pass. Analyses that only report
+    // diagnostics use 0 so they always run.
+    unsigned level;
+
+    // Enabled syscall rules don't get a walk each: they run together in a
+    // single one, before the AST passes (see RuleSet).
+    std::variant<SyscallRule, AstPass, IrPass, LoweringOption, BpfPass> run;
+};
+
+// Runs the passes of each stage in registration order. The set of enabled
+// passes comes from the optimisation level (-O0 up to -O3) and can be
+// overridden per pass.
+class PassManager
+{
+public:
+    static constexpr unsigned max_level = 3;
+
+    // Owns the name, as add() may move the passes
+    struct Timing
+    {
+        std::string pass;
+        std::chrono::nanoseconds elapsed;
+    };
+
+    // Registers the built-in passes at level 2.
+    PassManager();
+
+    void add(Pass pass);
+
+    // Throws std::invalid_argument for levels above max_level.
+    void set_level(unsigned level);
+
+    // Throws std::invalid_argument for unknown passes.
+    void set_enabled(std::string_view pass, bool enabled);
+
+    bool enabled(const Pass& pass) const;
+
+    // Accepts -O<level>, -f<pass>, -fno-<pass> and -j[<jobs>]. Returns false if
+    // `arg` isn't one of these.
+    bool parse_option(std::string_view arg);
+
+    void run(
+        Context& context, Diagnostics& diagnostics,
+        std::vector<ast::ProgramStatement>& ast);
+    void run(Diagnostics& diagnostics, ir::DecisionTable& table);
+    void run(bpf::Program& program);
+
+    CodegenOptions codegen_options() const;
+
+    const std::vector<Pass>& passes() const
+    {
+        return passes_;
+    }
+
+    // Threads for parsing (see Compiler::compile()) and for checking syscall
+    // rules, 0 for one per core (-j or -j0)
+    unsigned jobs = 1;
+
+    // Filled on every run while `time_passes` is set, cleared by
+    // Compiler::reset()
+    bool time_passes = false;
+    std::vector<Timing> timings;
+
+    void print_timings(std::ostream& out) const;
+
+private:
+    template<class F, class... Args>
+    void run_stage(Args&... args);
+
+    std::vector<Pass> passes_;
+    std::unordered_map<std::string, bool> overrides;
+    unsigned level = 2;
+};
+
+} // namespace fekal
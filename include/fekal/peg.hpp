@@ -5,3 +5,4 @@
 
 #include <fekal/peg/recursion_context.hpp>
 #include <fekal/peg/choice.hpp>
+#include <fekal/peg/first.hpp>
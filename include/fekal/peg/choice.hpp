@@ -3,12 +3,33 @@
 
 #pragma once
 
+#include <fekal/peg/first.hpp>
+#include <type_traits>
+#include <utility>
+
+#if defined(FEKAL_CHECK_FIRST_SETS)
+#include <stdexcept>
+#endif // defined(FEKAL_CHECK_FIRST_SETS)
+
 namespace fekal::peg {
 
+// Alternatives are tried in order. Guarded alternatives (see guard()) that
+// can't start with the current token are skipped.
 template<class Recur, class Reader, class F>
 static inline
 auto choice(const Recur& recur, Reader& r, F&& f)
 {
+    if (!may_start_with<std::decay_t<F>>(r.symbol())) {
+#if defined(FEKAL_CHECK_FIRST_SETS)
+        // as in basic_recursion_context::enter()
+        auto copy = r;
+        if (recur.test(f(recur, copy))) {
+            throw std::logic_error{"FIRST set misses a token"};
+        }
+#endif // defined(FEKAL_CHECK_FIRST_SETS)
+        return std::invoke_result_t<F&, const Recur&, Reader&>{};
+    }
+
     auto backup = r;
     auto res = f(recur, r);
     if (!recur.test(res)) {
@@ -21,6 +42,18 @@ template<class Recur, class Reader, class F1, class F2, class... F3>
 static inline
 auto choice(const Recur& recur, Reader& reader, F1&& f1, F2&& f2, F3&&... f3)
 {
+    if (!may_start_with<std::decay_t<F1>>(reader.symbol())) {
+#if defined(FEKAL_CHECK_FIRST_SETS)
+        // as in basic_recursion_context::enter()
+        auto copy = reader;
+        if (recur.test(f1(recur, copy))) {
+            throw std::logic_error{"FIRST set misses a token"};
+        }
+#endif // defined(FEKAL_CHECK_FIRST_SETS)
+        return choice(
+            recur, reader, std::forward<F2>(f2), std::forward<F3>(f3)...);
+    }
+
     auto backup = reader;
     if (auto res = f1(recur, reader) ; recur.test(res)) {
         return res;
@@ -0,0 +1,117 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+
+namespace fekal::peg {
+
+// FIRST sets: the tokens a match may start with. basic_recursion_context::enter
+// and choice() skip a rule or an alternative whose set rules out the current
+// token without calling it. A set may be larger than the exact FIRST set of
+// the rule, never smaller. Builds with FEKAL_CHECK_FIRST_SETS run skipped rules
+// and alternatives anyway and throw std::logic_error if one matches.
+namespace detail {
+
+template<class Symbol>
+constexpr bool in_mask(std::uint64_t mask, Symbol s)
+{
+    auto i = static_cast<std::uint64_t>(s);
+    return i < 64 && (mask >> i & 1);
+}
+
+} // namespace detail
+
+// Sets of symbols below 64 (such as token::symbol) are tested as a bit mask
+template<auto... Symbols>
+struct first
+{
+    static constexpr bool has_mask =
+        ((static_cast<std::uint64_t>(Symbols) < 64) && ...);
+
+    static constexpr std::uint64_t mask = []() {
+        std::uint64_t ret = 0;
+        if constexpr (has_mask) {
+            ((ret |= std::uint64_t{1} << static_cast<std::uint64_t>(Symbols)),
+             ...);
+        }
+        return ret;
+    }();
+
+    template<class Symbol>
+    static constexpr bool contains(Symbol s)
+    {
+        if constexpr (has_mask) {
+            return detail::in_mask(mask, s);
+        } else {
+            return ((s == Symbols) || ...);
+        }
+    }
+};
+
+template<class... Sets>
+struct first_union
+{
+    static constexpr bool has_mask = (Sets::has_mask && ...);
+    static constexpr std::uint64_t mask = (Sets::mask | ...);
+
+    template<class Symbol>
+    static constexpr bool contains(Symbol s)
+    {
+        if constexpr (has_mask) {
+            return detail::in_mask(mask, s);
+        } else {
+            return (Sets::contains(s) || ...);
+        }
+    }
+};
+
+// Rules without a FIRST set are always tried
+struct any_first
+{
+    static constexpr bool has_mask = false;
+    static constexpr std::uint64_t mask = 0;
+
+    template<class Symbol>
+    static constexpr bool contains(Symbol)
+    {
+        return true;
+    }
+};
+
+// Specialize to give a rule function its FIRST set, e.g.:
+//
+//     template<> struct peg::rule_first<Policy>
+//         : peg::first<token::symbol::KW_POLICY> {};
+template<auto Fn>
+struct rule_first : any_first
+{};
+
+// An alternative for choice() that is only tried when `Set` admits the
+// current token
+template<class Set, class F>
+struct guarded : F
+{
+    using first_type = Set;
+};
+
+template<class Set, class F>
+guarded<Set, std::decay_t<F>> guard(F&& f)
+{
+    return {std::forward<F>(f)};
+}
+
+template<class F, class Symbol>
+constexpr bool may_start_with(Symbol s)
+{
+    if constexpr (requires { typename F::first_type; }) {
+        return F::first_type::contains(s);
+    } else {
+        return true;
+    }
+}
+
+} // namespace fekal::peg
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <type_traits>
+#include <stdexcept>
 #include <cassert>
 #include <variant>
 #include <bitset>
@@ -13,10 +14,22 @@
 #include <boost/mp11/integral.hpp>
 #include <boost/mp11/list.hpp>
 
-#if !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#include <fekal/peg/first.hpp>
+
+#if defined(FEKAL_DISABLE_PEG_MEMOIZATION) && \
+    defined(FEKAL_PEG_HASHED_MEMOIZATION)
+#error FEKAL_PEG_HASHED_MEMOIZATION needs memoization enabled
+#endif
+
+#if defined(FEKAL_PEG_HASHED_MEMOIZATION)
 #include <unordered_map>
 #include <vector>
-#endif // !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#include <tuple>
+#elif !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#include <cstdint>
+#include <vector>
+#include <tuple>
+#endif
 
 namespace fekal::peg {
 
@@ -42,17 +55,28 @@ struct basic_recursion_context
     template<auto Fn>
     using return_type = recursion_context_return_type<Reader, Rules, Fn>;
 
-#if !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#if defined(FEKAL_PEG_HASHED_MEMOIZATION)
     using cache_type = Rules::cache_type;
 
+    // Results memoized for `Fn` at the position of `reader`
     template<auto Fn>
-    std::unordered_map<
-        const void*, std::vector<std::pair<return_type<Fn>, Reader>>
-    >& cache_for() const
+    std::vector<std::pair<return_type<Fn>, Reader>>&
+    cache_for(const Reader& reader) const
     {
-        return std::get<index<Fn>()>(cache->container);
+        auto& c = std::get<index<Fn>()>(cache->container);
+        return c[reader.ordinal()];
     }
-#endif // !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#elif !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+    using cache_type = Rules::cache_type;
+
+    // Results memoized for `Fn` at the position of `reader`
+    template<auto Fn>
+    auto cache_for(const Reader& reader) const
+    {
+        auto& c = std::get<index<Fn>()>(cache->container);
+        return c.at(reader.ordinal() - cache->origin);
+    }
+#endif // defined(FEKAL_PEG_HASHED_MEMOIZATION)
 
 #if defined(FEKAL_DISABLE_PEG_MEMOIZATION)
     basic_recursion_context(const Reader& reader) : reader{reader} {}
@@ -103,7 +127,7 @@ struct basic_recursion_context
 
 #if !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
                 if (
-                    auto& c = cache_for<Fn>()[reader.literal().data()] ;
+                    auto&& c = cache_for<Fn>(reader) ;
                     lim < c.size()
                 ) {
                     reader = c[lim].second;
@@ -118,7 +142,7 @@ struct basic_recursion_context
         }
 
 #if !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
-        auto& c = cache_for<Fn>()[reader.literal().data()];
+        auto&& c = cache_for<Fn>(reader);
         if (c.size() > 0) {
             reader = c.back().second;
             return c.back().first;
@@ -159,6 +183,17 @@ struct basic_recursion_context
     return_type<Fn> enter(Reader& reader) const
     {
         using Tag = boost::mp11::mp_bool<index<Fn>() == Rules::mp_fn_list_size>;
+        if (!rule_first<Fn>::contains(reader.symbol())) {
+#if defined(FEKAL_CHECK_FIRST_SETS)
+            // a FIRST set that misses a token would silently drop matches.
+            // Runs every skipped rule, so only the tests built for it pay.
+            auto r = reader;
+            if (test(enter_impl<Fn>(r, Tag{}))) {
+                throw std::logic_error{"FIRST set misses a token"};
+            }
+#endif // defined(FEKAL_CHECK_FIRST_SETS)
+            return {};
+        }
         return enter_impl<Fn>(reader, Tag{});
     }
 
@@ -214,17 +249,189 @@ struct basic_recursion_context
 template<class Reader, class Rules, auto... Fns>
 struct basic_recursion_context_rules
 {
-#if !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#if defined(FEKAL_PEG_HASHED_MEMOIZATION)
+    // One hash map per rule. Its node and bucket accesses scatter once the
+    // memo outgrows the CPU caches, so parse time on long expressions grows
+    // faster than the input. Kept for comparison in the benchmarks.
     struct cache_type
     {
+        // keyed by token ordinal
         template<class T>
         using container_type = std::unordered_map<
-            const void*, std::vector<std::pair<T, Reader>>>;
+            unsigned, std::vector<std::pair<T, Reader>>>;
+
+        // Forgets the entries. The maps keep their buckets.
+        void reset(const Reader&)
+        {
+            std::apply([](auto&... c) { (c.clear(), ...); }, container);
+        }
+
+        std::size_t size() const
+        {
+            return std::apply([](const auto&... c) {
+                return (std::size_t{0} + ... + entries(c));
+            }, container);
+        }
+
+        // An estimate: the bucket array, one node per position and the
+        // vectors of entries. Allocator overhead isn't counted.
+        std::size_t memory() const
+        {
+            return std::apply([](const auto&... c) {
+                return (std::size_t{0} + ... + bytes(c));
+            }, container);
+        }
+
+        template<class T>
+        static std::size_t entries(const container_type<T>& c)
+        {
+            std::size_t ret = 0;
+            for (const auto& [pos, v] : c) {
+                ret += v.size();
+            }
+            return ret;
+        }
+
+        template<class T>
+        static std::size_t bytes(const container_type<T>& c)
+        {
+            using node = typename container_type<T>::value_type;
+            std::size_t ret = c.bucket_count() * sizeof(void*) +
+                c.size() * (sizeof(node) + sizeof(void*));
+            for (const auto& [pos, v] : c) {
+                ret += v.capacity() * sizeof(std::pair<T, Reader>);
+            }
+            return ret;
+        }
 
         std::tuple<container_type<
             recursion_context_return_type<Reader, Rules, Fns>>...> container;
     };
-#endif // !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+#elif !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+    // One array per rule, indexed by the ordinal of the token where the rule
+    // was entered (relative to `origin`). No hashing, and no allocation per
+    // position: all entries of a rule live in a single vector. Entries for one
+    // position are appended while the rule grows a left-recursive match, and
+    // entries for other positions may be appended in between, so each one
+    // links to the previous entry for the same position.
+    //
+    // reset() forgets the entries but keeps the buffers, so one cache serves
+    // every statement of a parse.
+    //
+    // The default store. Define FEKAL_PEG_HASHED_MEMOIZATION for hash maps
+    // instead.
+    struct cache_type
+    {
+        template<class T>
+        struct container_type
+        {
+            using value_type = std::pair<T, Reader>;
+
+            struct slot
+            {
+                // index of the last entry plus one (0 if none)
+                std::uint32_t last = 0;
+                std::uint32_t size = 0;
+            };
+
+            // Entries at one position. Stays valid while the arrays grow.
+            class list
+            {
+            public:
+                list(container_type& c, std::size_t pos)
+                    : c{&c}
+                    , pos{pos}
+                {}
+
+                std::size_t size() const
+                {
+                    return c->slots[pos].size;
+                }
+
+                value_type& back() const
+                {
+                    return c->entries[c->slots[pos].last - 1];
+                }
+
+                // Walks back from the last entry. Left-recursive rules only
+                // ever grow a handful of entries per position.
+                value_type& operator[](std::size_t i) const
+                {
+                    auto idx = c->slots[pos].last - 1;
+                    for (auto n = size() - 1 - i ; n > 0 ; --n) {
+                        idx = c->previous[idx] - 1;
+                    }
+                    return c->entries[idx];
+                }
+
+                void emplace_back(const T& value, const Reader& reader) const
+                {
+                    auto& s = c->slots[pos];
+                    c->entries.emplace_back(value, reader);
+                    c->previous.push_back(s.last);
+                    s.last = static_cast<std::uint32_t>(c->entries.size());
+                    ++s.size;
+                }
+
+            private:
+                container_type* c;
+                std::size_t pos;
+            };
+
+            list at(std::size_t pos)
+            {
+                if (pos >= slots.size()) {
+                    slots.resize(pos + 1);
+                }
+                return {*this, pos};
+            }
+
+            void clear()
+            {
+                slots.clear();
+                entries.clear();
+                previous.clear();
+            }
+
+            std::size_t memory() const
+            {
+                return slots.capacity() * sizeof(slot) +
+                    entries.capacity() * sizeof(value_type) +
+                    previous.capacity() * sizeof(std::uint32_t);
+            }
+
+            std::vector<slot> slots;
+            std::vector<value_type> entries;
+            std::vector<std::uint32_t> previous;
+        };
+
+        void reset(const Reader& reader)
+        {
+            origin = reader.ordinal();
+            std::apply([](auto&... c) { (c.clear(), ...); }, container);
+        }
+
+        // Entries held since the last reset()
+        std::size_t size() const
+        {
+            return std::apply([](const auto&... c) {
+                return (std::size_t{0} + ... + c.entries.size());
+            }, container);
+        }
+
+        // Bytes reserved by the buffers, which reset() keeps
+        std::size_t memory() const
+        {
+            return std::apply([](const auto&... c) {
+                return (std::size_t{0} + ... + c.memory());
+            }, container);
+        }
+
+        std::tuple<container_type<
+            recursion_context_return_type<Reader, Rules, Fns>>...> container;
+        unsigned origin = 0;
+    };
+#endif // defined(FEKAL_PEG_HASHED_MEMOIZATION)
 
     using mp_fn_list = boost::mp11::mp_list<boost::mp11::mp_value<Fns>...>;
     static constexpr auto mp_fn_list_size = sizeof...(Fns);
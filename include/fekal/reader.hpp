@@ -8,6 +8,25 @@
 
 namespace fekal {
 
+// Value of a token given its literal
+template<token::symbol S>
+token::value_type<S> decode(std::string_view literal);
+
+template<>
+std::string_view decode<token::symbol::IDENTIFIER>(std::string_view literal);
+
+template<>
+std::int64_t decode<token::symbol::LIT_BIN>(std::string_view literal);
+
+template<>
+std::int64_t decode<token::symbol::LIT_OCT>(std::string_view literal);
+
+template<>
+std::int64_t decode<token::symbol::LIT_DEC>(std::string_view literal);
+
+template<>
+std::int64_t decode<token::symbol::LIT_HEX>(std::string_view literal);
+
 // Rationale:
 //
 // - It doesn't perform syscalls/IO.
@@ -37,12 +56,21 @@ public:
     reader& operator=(const reader&) = default;
 
     token::symbol symbol() const;
-    template<token::symbol S> token::value_type<S> value() const;
+    template<token::symbol S>
+    token::value_type<S> value() const
+    {
+        return decode<S>(literal());
+    }
+
     unsigned line() const;
     unsigned column() const;
     std::string_view literal() const;
     std::string_view tail() const;
 
+    // Position of the current token, counted in tokens from the start of the
+    // input
+    unsigned ordinal() const;
+
     bool next();
 
     // Undefined behavior if used against readers that never pointed to the same
@@ -60,25 +88,11 @@ private:
     const char* cursor;
     unsigned line_ = 1;
     unsigned column_ = 0;
+    unsigned ordinal_ = 0;
     token::symbol symbol_;
 };
 
 static_assert(std::is_trivially_copy_constructible_v<reader> &&
               std::is_trivially_destructible_v<reader>);
 
-template<>
-std::string reader::value<token::symbol::IDENTIFIER>() const;
-
-template<>
-std::int64_t reader::value<token::symbol::LIT_BIN>() const;
-
-template<>
-std::int64_t reader::value<token::symbol::LIT_OCT>() const;
-
-template<>
-std::int64_t reader::value<token::symbol::LIT_DEC>() const;
-
-template<>
-std::int64_t reader::value<token::symbol::LIT_HEX>() const;
-
 } // namespace fekal
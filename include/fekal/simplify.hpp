@@ -0,0 +1,21 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/diagnostics.hpp>
+#include <fekal/ir.hpp>
+
+namespace fekal {
+
+// Abstract interpretation of guards. Each argument is tracked as an unsigned
+// interval plus the bits known to be set or clear, refined by the conditions
+// already taken on the way to a comparison (`x == 1 && x == 2`). Comparisons
+// decided at compile time are folded away and reported as warnings since
+// they're most likely mistakes in the policy.
+//
+// An alternative that always holds makes its rule unconditional. A rule left
+// without alternatives never matches and is removed.
+void simplify_guards(Diagnostics& diagnostics, ir::DecisionTable& table);
+
+} // namespace fekal
@@ -0,0 +1,45 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <string_view>
+#include <cstddef>
+#include <string>
+#include <memory>
+
+namespace fekal {
+
+// Owns the text of a policy. Names in ASTs parsed from it (identifiers,
+// syscalls, policies and versions) are views into this text, so the AST must
+// not outlive it. Numeric versions are the exception: they view their decimal
+// rendering, interned for the lifetime of the process (see symbols.hpp).
+//
+// Moves leave the text where it is, so views taken before a move stay valid.
+class SourceFile
+{
+public:
+    explicit SourceFile(std::string text);
+
+    // Maps the file into memory. Files that can't be mapped (e.g. pipes) are
+    // read instead.
+    static SourceFile open(const char* path);
+
+    SourceFile(SourceFile&& o) noexcept;
+    SourceFile& operator=(SourceFile&& o) noexcept;
+    ~SourceFile();
+
+    std::string_view text() const;
+
+private:
+    SourceFile() = default;
+
+    // text read from a pipe or given to the constructor
+    std::unique_ptr<char[]> buffer;
+    std::size_t buffer_size = 0;
+
+    void* mapping = nullptr;
+    std::size_t mapping_size = 0;
+};
+
+} // namespace fekal
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+namespace fekal {
+
+// Dense ids for the names found in policies: syscalls, parameters, policy
+// names and versions. Ids are process-wide, so equal spellings get equal ids
+// whatever source they come from, and names are compared and hashed as
+// integers. Spellings are kept for the lifetime of the process.
+//
+// Thread-safe.
+using SymbolId = std::uint32_t;
+
+// Always the id of "_"
+inline constexpr SymbolId blank_symbol = 0;
+
+SymbolId intern(std::string_view name);
+std::string_view spelling(SymbolId id);
+
+// What checker scopes are keyed by: a plain name, or the name/version pair
+// of a policy. Pairs don't collide with plain names nor with each other.
+using SymbolKey = std::uint64_t;
+
+constexpr SymbolKey symbol_key(SymbolId name)
+{
+    return name;
+}
+
+constexpr SymbolKey symbol_key(SymbolId name, SymbolId version)
+{
+    return (SymbolKey{version} + 1) << 32 | name;
+}
+
+inline SymbolKey symbol_key(std::string_view name, std::string_view version)
+{
+    return symbol_key(intern(name), intern(version));
+}
+
+} // namespace fekal
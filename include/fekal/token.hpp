@@ -69,7 +69,7 @@ template<token::symbol S>
 using value_type = decltype(+boost::hana::make_map(
     boost::hana::make_pair(
         boost::hana::int_c<static_cast<int>(symbol::IDENTIFIER)>,
-        boost::hana::type_c<std::string>),
+        boost::hana::type_c<std::string_view>),
     boost::hana::make_pair(
         boost::hana::int_c<static_cast<int>(symbol::LIT_BIN)>,
         boost::hana::type_c<std::int64_t>),
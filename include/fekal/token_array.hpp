@@ -0,0 +1,137 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/reader.hpp>
+#include <exception>
+#include <cstdint>
+#include <vector>
+
+namespace fekal {
+
+// The whole input lexed in advance. The parser copies its reader for every
+// lookahead and backtracks by assigning the copy back, so a plain reader runs
+// the lexer again over the same bytes after each retry. Over a TokenArray,
+// a retry is an index reset.
+//
+// A lexer error isn't thrown up front. Tokens are kept up to the offending
+// one and the error is thrown when a cursor moves past the last of them, just
+// as reader::next() would have thrown.
+class TokenArray
+{
+public:
+    struct Token
+    {
+        token::symbol symbol;
+        std::uint32_t offset;
+        std::uint32_t length;
+        std::uint32_t line;
+        std::uint32_t column;
+    };
+
+    explicit TokenArray(std::string_view input);
+
+    std::string_view input() const
+    {
+        return input_;
+    }
+
+    // Ends with an END token unless lexing failed
+    const std::vector<Token>& tokens() const
+    {
+        return tokens_;
+    }
+
+    const std::exception_ptr& error() const
+    {
+        return error_;
+    }
+
+private:
+    std::string_view input_;
+    std::vector<Token> tokens_;
+    std::exception_ptr error_;
+};
+
+// Walks a TokenArray with the interface of reader, which the parser and
+// peg::basic_recursion_context rely on. The array must outlive the cursor.
+class token_cursor
+{
+public:
+    // Throws if the first token is invalid
+    explicit token_cursor(const TokenArray& tokens);
+
+    token_cursor(const token_cursor&) = default;
+    token_cursor& operator=(const token_cursor&) = default;
+
+    token::symbol symbol() const
+    {
+        return current().symbol;
+    }
+
+    template<token::symbol S>
+    token::value_type<S> value() const
+    {
+        return decode<S>(literal());
+    }
+
+    unsigned line() const
+    {
+        return current().line;
+    }
+
+    unsigned column() const
+    {
+        return current().column;
+    }
+
+    std::string_view literal() const
+    {
+        return tokens->input().substr(current().offset, current().length);
+    }
+
+    std::string_view tail() const
+    {
+        return tokens->input().substr(current().offset + current().length);
+    }
+
+    // Index of the current token
+    unsigned ordinal() const
+    {
+        return index;
+    }
+
+    bool next();
+
+    // Only meaningful between cursors over the same array {{{
+    bool operator==(const token_cursor& o) const
+    {
+        return index == o.index;
+    }
+
+    bool operator!=(const token_cursor& o) const
+    {
+        return index != o.index;
+    }
+
+    bool operator<(const token_cursor& o) const
+    {
+        return index < o.index;
+    }
+    // }}}
+
+private:
+    const TokenArray::Token& current() const
+    {
+        return tokens->tokens()[index];
+    }
+
+    const TokenArray* tokens;
+    std::uint32_t index = 0;
+};
+
+static_assert(std::is_trivially_copy_constructible_v<token_cursor> &&
+              std::is_trivially_destructible_v<token_cursor>);
+
+} // namespace fekal
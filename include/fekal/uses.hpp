@@ -0,0 +1,63 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/ast.hpp>
+#include <fekal/diagnostics.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+
+namespace fekal {
+
+// Resolves USE statements over the graph of policies. The flattened form of
+// each policy is computed once and memoised by Policy::key(), so shared
+// policies aren't expanded again for every importer.
+//
+// resolve() may be called concurrently.
+class UseResolver
+{
+public:
+    struct Entry
+    {
+        // Policy declaring the block
+        const ast::Policy* policy;
+        const ast::ActionBlock* block;
+    };
+
+    // Action blocks in expansion order. USE statements are expanded in place,
+    // but a policy already reached earlier (or through another import)
+    // contributes nothing the second time.
+    using Flattened = std::vector<Entry>;
+
+    // The AST must outlive the resolver.
+    explicit UseResolver(const std::vector<ast::ProgramStatement>& ast);
+
+    // Unknown policies flatten to nothing. USE statements closing a cycle are
+    // ignored, so check() must succeed for the results to be meaningful.
+    std::shared_ptr<const Flattened> resolve(SymbolKey key) const;
+
+    // Policies reached, directly or not, from USE statements at the top level.
+    // Only these end up in the generated filter.
+    std::unordered_set<const ast::Policy*> reachable() const;
+
+    // Reports cycles and policies used twice from the same body.
+    void check(Diagnostics& diagnostics) const;
+
+private:
+    std::shared_ptr<const Flattened> resolve(
+        SymbolKey key, std::vector<SymbolKey>& path) const;
+
+    const std::vector<ast::ProgramStatement>& ast;
+
+    // First declaration wins; duplicates are reported by the checker
+    std::unordered_map<SymbolKey, const ast::Policy*> policies;
+
+    mutable std::mutex mutex;
+    mutable std::unordered_map<SymbolKey, std::shared_ptr<const Flattened>>
+        memo;
+};
+
+} // namespace fekal
@@ -0,0 +1,75 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/arch.hpp>
+#include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <memory>
+#include <array>
+
+#include <linux/audit.h>
+#include <seccomp.h>
+
+namespace fekal {
+
+// Only little-endian archs are listed. The code generator assumes the low half
+// of every 64-bit argument lives at the lower address of seccomp_data.
+static constexpr std::array archs{
+    Arch{"x86_64", AUDIT_ARCH_X86_64, true, /*__X32_SYSCALL_BIT=*/0x40000000},
+    Arch{"x86", AUDIT_ARCH_I386, false},
+    Arch{"aarch64", AUDIT_ARCH_AARCH64, true},
+    Arch{"arm", AUDIT_ARCH_ARM, false},
+    Arch{"riscv64", AUDIT_ARCH_RISCV64, true},
+};
+
+std::span<const Arch> supported_archs()
+{
+    return archs;
+}
+
+const Arch& native_arch()
+{
+    static const Arch& native = []() -> const Arch& {
+        auto token = seccomp_arch_native();
+        auto it = std::ranges::find(archs, token, &Arch::token);
+        if (it == archs.end()) {
+            throw std::runtime_error{"unsupported native arch"};
+        }
+        return *it;
+    }();
+    return native;
+}
+
+const Arch* find_arch(std::string_view name)
+{
+    auto it = std::ranges::find(archs, name, &Arch::name);
+    if (it == archs.end()) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+std::optional<std::uint32_t> resolve_syscall(
+    const Arch& arch, std::string_view name)
+{
+    // libseccomp returns negative pseudo-syscall numbers for syscalls that it
+    // knows about, but which don't exist on the given arch
+    int nr = seccomp_syscall_resolve_name_arch(
+        arch.token, std::string{name}.c_str());
+    if (nr < 0) {
+        return std::nullopt;
+    }
+    return static_cast<std::uint32_t>(nr);
+}
+
+std::string syscall_name(const Arch& arch, std::uint32_t nr)
+{
+    std::unique_ptr<char, decltype(&std::free)> name{
+        seccomp_syscall_resolve_num_arch(arch.token, static_cast<int>(nr)),
+        &std::free};
+    return name ? std::string{name.get()} : std::string{};
+}
+
+} // namespace fekal
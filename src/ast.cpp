@@ -2,60 +2,102 @@
 // SPDX-License-Identifier: MIT-0
 
 #include <fekal/ast.hpp>
+#include <fekal/constants.hpp>
 #include <boost/hana/functional/overload.hpp>
 
 namespace fekal {
 
 namespace hana = boost::hana;
 
-static std::int64_t eval_int(const ast::IntExpr& e)
+std::uint64_t eval(const ast::IntExpr& e, const Bindings& bindings)
 {
+    auto recur = [&](const auto& e) { return eval(*e, bindings); };
     return std::visit(hana::overload(
-        [](const ast::IntLit& e) { return e.value; },
-        [](const ast::Identifier&) -> std::int64_t { return 0; },
-        [](const ast::SumExpr& e) {
-            return eval_int(*e.left) + eval_int(*e.right); },
-        [](const ast::SubtractExpr& e) {
-            return eval_int(*e.left) - eval_int(*e.right); },
-        [](const ast::MulExpr& e) {
-            return eval_int(*e.left) * eval_int(*e.right); },
-        [](const ast::DivExpr& e) {
-            return eval_int(*e.left) / eval_int(*e.right); },
-        [](const ast::LshiftExpr& e) {
-            return eval_int(*e.left) << eval_int(*e.right); },
-        [](const ast::RshiftExpr& e) {
-            return eval_int(*e.left) >> eval_int(*e.right); },
-        [](const ast::BitAndExpr& e) {
-            return eval_int(*e.left) & eval_int(*e.right); },
-        [](const ast::BitXorExpr& e) {
-            return eval_int(*e.left) ^ eval_int(*e.right); },
-        [](const ast::BitOrExpr& e) {
-            return eval_int(*e.left) | eval_int(*e.right); }
+        [](const ast::IntLit& e) {
+            return static_cast<std::uint64_t>(e.value); },
+        [&](const ast::Identifier& e) -> std::uint64_t {
+            if (auto it = bindings.find(e.value) ; it != bindings.end()) {
+                return it->second;
+            }
+            return find_constant(e.value).value_or(0);
+        },
+        [&](const ast::SumExpr& e) { return recur(e.left) + recur(e.right); },
+        [&](const ast::SubtractExpr& e) {
+            return recur(e.left) - recur(e.right); },
+        [&](const ast::MulExpr& e) { return recur(e.left) * recur(e.right); },
+        [&](const ast::DivExpr& e) -> std::uint64_t {
+            auto d = recur(e.right);
+            return d != 0 ? recur(e.left) / d : 0;
+        },
+        [&](const ast::LshiftExpr& e) -> std::uint64_t {
+            auto n = recur(e.right);
+            return n < 64 ? recur(e.left) << n : 0;
+        },
+        [&](const ast::RshiftExpr& e) -> std::uint64_t {
+            auto n = recur(e.right);
+            return n < 64 ? recur(e.left) >> n : 0;
+        },
+        [&](const ast::BitAndExpr& e) {
+            return recur(e.left) & recur(e.right); },
+        [&](const ast::BitXorExpr& e) {
+            return recur(e.left) ^ recur(e.right); },
+        [&](const ast::BitOrExpr& e) {
+            return recur(e.left) | recur(e.right); }
     ), e);
 }
 
-bool eval(const ast::BoolExpr& e)
+bool eval(const ast::BoolExpr& e, const Bindings& bindings)
 {
+    auto recur = [&](const auto& e) { return eval(*e, bindings); };
     return std::visit(hana::overload(
-        [](const ast::EqExpr& e) {
-            return eval_int(*e.left) == eval_int(*e.right); },
-        [](const ast::NeqExpr& e) {
-            return eval_int(*e.left) != eval_int(*e.right); },
-        [](const ast::LtExpr& e) {
-            return eval_int(*e.left) < eval_int(*e.right); },
-        [](const ast::GtExpr& e) {
-            return eval_int(*e.left) > eval_int(*e.right); },
-        [](const ast::LteExpr& e) {
-            return eval_int(*e.left) <= eval_int(*e.right); },
-        [](const ast::GteExpr& e) {
-            return eval_int(*e.left) >= eval_int(*e.right); },
-        [](const ast::NegExpr& e) {
-            return !eval(*e.inner); },
-        [](const ast::AndExpr& e) {
-            return (eval(*e.left) && eval(*e.right)); },
-        [](const ast::OrExpr& e) {
-            return (eval(*e.left) || eval(*e.right)); }
+        [&](const ast::EqExpr& e) { return recur(e.left) == recur(e.right); },
+        [&](const ast::NeqExpr& e) { return recur(e.left) != recur(e.right); },
+        [&](const ast::LtExpr& e) { return recur(e.left) < recur(e.right); },
+        [&](const ast::GtExpr& e) { return recur(e.left) > recur(e.right); },
+        [&](const ast::LteExpr& e) { return recur(e.left) <= recur(e.right); },
+        [&](const ast::GteExpr& e) { return recur(e.left) >= recur(e.right); },
+        [&](const ast::NegExpr& e) { return !recur(e.inner); },
+        [&](const ast::AndExpr& e) { return recur(e.left) && recur(e.right); },
+        [&](const ast::OrExpr& e) { return recur(e.left) || recur(e.right); }
     ), e);
 }
 
+bool equivalent(const ast::IntExpr& a, const ast::IntExpr& b)
+{
+    if (&a == &b) {
+        return true;
+    } else if (a.index() != b.index()) {
+        return false;
+    }
+    return std::visit(hana::overload(
+        [&](const ast::IntLit& e) {
+            return e.value == std::get<ast::IntLit>(b).value; },
+        [&](const ast::Identifier& e) {
+            return e.value == std::get<ast::Identifier>(b).value; },
+        [&]<class T>(const T& e) {
+            const auto& o = std::get<T>(b);
+            return equivalent(*e.left, *o.left) &&
+                equivalent(*e.right, *o.right);
+        }
+    ), a);
+}
+
+bool equivalent(const ast::BoolExpr& a, const ast::BoolExpr& b)
+{
+    if (&a == &b) {
+        return true;
+    } else if (a.index() != b.index()) {
+        return false;
+    }
+    return std::visit(hana::overload(
+        [&](const ast::NegExpr& e) {
+            return equivalent(*e.inner, *std::get<ast::NegExpr>(b).inner); },
+        [&]<class T>(const T& e) {
+            const auto& o = std::get<T>(b);
+            return equivalent(*e.left, *o.left) &&
+                equivalent(*e.right, *o.right);
+        }
+    ), a);
+}
+
 } // namespace fekal
@@ -0,0 +1,422 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/bpf.hpp>
+#include <stdexcept>
+#include <optional>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <map>
+
+namespace fekal::bpf {
+
+Result emulate(std::span<const sock_filter> program, const seccomp_data& data)
+{
+    std::uint32_t a = 0;
+    std::uint32_t x = 0;
+    std::array<std::uint32_t, BPF_MEMWORDS> mem{};
+    unsigned executed = 0;
+
+    for (std::size_t pc = 0 ; pc < program.size() ; ++pc) {
+        const auto& insn = program[pc];
+        ++executed;
+
+        auto src = [&]() {
+            return BPF_SRC(insn.code) == BPF_X ? x : insn.k;
+        };
+        auto jump = [&](bool cond) {
+            pc += cond ? insn.jt : insn.jf;
+        };
+        auto slot = [&]() -> std::uint32_t& {
+            if (insn.k >= BPF_MEMWORDS) {
+                throw std::runtime_error{"scratch memory out of bounds"};
+            }
+            return mem[insn.k];
+        };
+
+        switch (insn.code) {
+        case BPF_LD | BPF_W | BPF_ABS:
+            if (insn.k % 4 != 0 || insn.k + 4 > sizeof(data)) {
+                throw std::runtime_error{"invalid load from seccomp_data"};
+            }
+            std::memcpy(&a, reinterpret_cast<const char*>(&data) + insn.k, 4);
+            break;
+        case BPF_LD | BPF_W | BPF_LEN:
+            a = sizeof(data);
+            break;
+        case BPF_LDX | BPF_W | BPF_LEN:
+            x = sizeof(data);
+            break;
+        case BPF_LD | BPF_IMM:
+            a = insn.k;
+            break;
+        case BPF_LDX | BPF_IMM:
+            x = insn.k;
+            break;
+        case BPF_LD | BPF_MEM:
+            a = slot();
+            break;
+        case BPF_LDX | BPF_MEM:
+            x = slot();
+            break;
+        case BPF_ST:
+            slot() = a;
+            break;
+        case BPF_STX:
+            slot() = x;
+            break;
+        case BPF_ALU | BPF_ADD | BPF_K:
+        case BPF_ALU | BPF_ADD | BPF_X:
+            a += src();
+            break;
+        case BPF_ALU | BPF_SUB | BPF_K:
+        case BPF_ALU | BPF_SUB | BPF_X:
+            a -= src();
+            break;
+        case BPF_ALU | BPF_MUL | BPF_K:
+        case BPF_ALU | BPF_MUL | BPF_X:
+            a *= src();
+            break;
+        case BPF_ALU | BPF_DIV | BPF_K:
+        case BPF_ALU | BPF_DIV | BPF_X:
+            if (src() == 0) {
+                // the kernel aborts the filter with a zero return
+                return {0, executed};
+            }
+            a /= src();
+            break;
+        case BPF_ALU | BPF_MOD | BPF_K:
+        case BPF_ALU | BPF_MOD | BPF_X:
+            if (src() == 0) {
+                return {0, executed};
+            }
+            a %= src();
+            break;
+        case BPF_ALU | BPF_AND | BPF_K:
+        case BPF_ALU | BPF_AND | BPF_X:
+            a &= src();
+            break;
+        case BPF_ALU | BPF_OR | BPF_K:
+        case BPF_ALU | BPF_OR | BPF_X:
+            a |= src();
+            break;
+        case BPF_ALU | BPF_XOR | BPF_K:
+        case BPF_ALU | BPF_XOR | BPF_X:
+            a ^= src();
+            break;
+        case BPF_ALU | BPF_LSH | BPF_K:
+        case BPF_ALU | BPF_LSH | BPF_X:
+            a = src() < 32 ? a << src() : 0;
+            break;
+        case BPF_ALU | BPF_RSH | BPF_K:
+        case BPF_ALU | BPF_RSH | BPF_X:
+            a = src() < 32 ? a >> src() : 0;
+            break;
+        case BPF_ALU | BPF_NEG:
+            a = -a;
+            break;
+        case BPF_JMP | BPF_JA:
+            pc += insn.k;
+            break;
+        case BPF_JMP | BPF_JEQ | BPF_K:
+        case BPF_JMP | BPF_JEQ | BPF_X:
+            jump(a == src());
+            break;
+        case BPF_JMP | BPF_JGT | BPF_K:
+        case BPF_JMP | BPF_JGT | BPF_X:
+            jump(a > src());
+            break;
+        case BPF_JMP | BPF_JGE | BPF_K:
+        case BPF_JMP | BPF_JGE | BPF_X:
+            jump(a >= src());
+            break;
+        case BPF_JMP | BPF_JSET | BPF_K:
+        case BPF_JMP | BPF_JSET | BPF_X:
+            jump((a & src()) != 0);
+            break;
+        case BPF_RET | BPF_K:
+            return {insn.k, executed};
+        case BPF_RET | BPF_A:
+            return {a, executed};
+        case BPF_MISC | BPF_TAX:
+            x = a;
+            break;
+        case BPF_MISC | BPF_TXA:
+            a = x;
+            break;
+        default:
+            throw std::runtime_error{"invalid BPF instruction"};
+        }
+    }
+
+    throw std::runtime_error{"BPF program doesn't end in a return"};
+}
+
+namespace {
+
+// Registers and scratch memory that are known at some point of the program.
+struct AbstractState
+{
+    std::optional<std::uint32_t> a;
+    std::optional<std::uint32_t> x;
+    std::array<std::optional<std::uint32_t>, BPF_MEMWORDS> mem;
+
+    auto operator<=>(const AbstractState&) const = default;
+};
+
+struct PathAnalysis
+{
+    std::span<const sock_filter> program;
+    std::uint32_t arch;
+    std::uint32_t nr;
+    std::map<std::pair<std::size_t, AbstractState>, unsigned> memo;
+
+    // Classic BPF only jumps forward, so recursion always terminates.
+    unsigned longest(std::size_t pc, AbstractState s)
+    {
+        auto key = std::make_pair(pc, s);
+        if (auto it = memo.find(key) ; it != memo.end()) {
+            return it->second;
+        }
+
+        if (pc >= program.size()) {
+            throw std::runtime_error{"BPF program doesn't end in a return"};
+        }
+
+        const auto& insn = program[pc];
+        auto src = BPF_SRC(insn.code) == BPF_X ? s.x :
+            std::optional<std::uint32_t>{insn.k};
+        auto alu = [&](auto op) {
+            if (s.a && src) {
+                s.a = op(*s.a, *src);
+            } else {
+                s.a.reset();
+            }
+        };
+        auto jump = [&](auto cond) {
+            if (s.a && src) {
+                return longest(pc + 1 + (cond(*s.a, *src) ? insn.jt : insn.jf), s);
+            }
+            return std::max(
+                longest(pc + 1 + insn.jt, s), longest(pc + 1 + insn.jf, s));
+        };
+
+        unsigned tail = 0;
+        switch (BPF_CLASS(insn.code)) {
+        case BPF_RET:
+            return memo[key] = 1;
+        case BPF_LD:
+            if (insn.code == (BPF_LD | BPF_W | BPF_ABS)) {
+                if (insn.k == offsetof(seccomp_data, arch)) {
+                    s.a = arch;
+                } else if (insn.k == offsetof(seccomp_data, nr)) {
+                    s.a = nr;
+                } else {
+                    s.a.reset();
+                }
+            } else if (insn.code == (BPF_LD | BPF_IMM)) {
+                s.a = insn.k;
+            } else if (insn.code == (BPF_LD | BPF_MEM)) {
+                s.a = s.mem.at(insn.k);
+            } else {
+                s.a = sizeof(seccomp_data);
+            }
+            tail = longest(pc + 1, s);
+            break;
+        case BPF_LDX:
+            if (insn.code == (BPF_LDX | BPF_IMM)) {
+                s.x = insn.k;
+            } else if (insn.code == (BPF_LDX | BPF_MEM)) {
+                s.x = s.mem.at(insn.k);
+            } else {
+                s.x = sizeof(seccomp_data);
+            }
+            tail = longest(pc + 1, s);
+            break;
+        case BPF_ST:
+            s.mem.at(insn.k) = s.a;
+            tail = longest(pc + 1, s);
+            break;
+        case BPF_STX:
+            s.mem.at(insn.k) = s.x;
+            tail = longest(pc + 1, s);
+            break;
+        case BPF_ALU:
+            switch (BPF_OP(insn.code)) {
+            case BPF_ADD: alu([](auto a, auto b) { return a + b; }); break;
+            case BPF_SUB: alu([](auto a, auto b) { return a - b; }); break;
+            case BPF_MUL: alu([](auto a, auto b) { return a * b; }); break;
+            case BPF_AND: alu([](auto a, auto b) { return a & b; }); break;
+            case BPF_OR: alu([](auto a, auto b) { return a | b; }); break;
+            case BPF_XOR: alu([](auto a, auto b) { return a ^ b; }); break;
+            case BPF_NEG:
+                if (s.a) {
+                    s.a = -*s.a;
+                }
+                break;
+            default:
+                // division, modulo and shifts aren't worth tracking
+                s.a.reset();
+            }
+            tail = longest(pc + 1, s);
+            break;
+        case BPF_JMP:
+            switch (BPF_OP(insn.code)) {
+            case BPF_JA:
+                tail = longest(pc + 1 + insn.k, s);
+                break;
+            case BPF_JEQ:
+                tail = jump([](auto a, auto b) { return a == b; });
+                break;
+            case BPF_JGT:
+                tail = jump([](auto a, auto b) { return a > b; });
+                break;
+            case BPF_JGE:
+                tail = jump([](auto a, auto b) { return a >= b; });
+                break;
+            case BPF_JSET:
+                tail = jump([](auto a, auto b) { return (a & b) != 0; });
+                break;
+            default:
+                throw std::runtime_error{"invalid BPF instruction"};
+            }
+            break;
+        case BPF_MISC:
+            if (BPF_MISCOP(insn.code) == BPF_TAX) {
+                s.x = s.a;
+            } else {
+                s.a = s.x;
+            }
+            tail = longest(pc + 1, s);
+            break;
+        }
+
+        return memo[key] = tail + 1;
+    }
+};
+
+} // namespace
+
+unsigned worst_case_path(
+    std::span<const sock_filter> program, std::uint32_t arch,
+    std::uint32_t nr)
+{
+    PathAnalysis analysis{program, arch, nr};
+    return analysis.longest(0, AbstractState{});
+}
+
+static bool is_conditional_jump(const sock_filter& insn)
+{
+    return BPF_CLASS(insn.code) == BPF_JMP && BPF_OP(insn.code) != BPF_JA;
+}
+
+void thread_jumps(Program& program)
+{
+    auto skip_ja = [&](std::size_t t) {
+        while (program.at(t).code == (BPF_JMP | BPF_JA)) {
+            t += 1 + program[t].k;
+        }
+        return t;
+    };
+
+    // Targets always come later in the program, so walking backwards sees
+    // them already threaded.
+    for (std::size_t i = program.size() ; i-- > 0 ;) {
+        auto& insn = program[i];
+        if (insn.code == (BPF_JMP | BPF_JA)) {
+            auto t = skip_ja(i + 1 + insn.k);
+            if (BPF_CLASS(program[t].code) == BPF_RET) {
+                insn = program[t];
+            } else {
+                insn.k = static_cast<std::uint32_t>(t - i - 1);
+            }
+            continue;
+        }
+        if (!is_conditional_jump(insn)) {
+            continue;
+        }
+
+        // A jump landing on the very same test (A and X are untouched) has
+        // its outcome decided already.
+        auto thread = [&](std::size_t t, bool taken) {
+            for (;;) {
+                t = skip_ja(t);
+                const auto& next = program[t];
+                if (next.code != insn.code || next.k != insn.k) {
+                    return t;
+                }
+                t += 1 + (taken ? next.jt : next.jf);
+            }
+        };
+        auto jt = thread(i + 1 + insn.jt, true) - i - 1;
+        auto jf = thread(i + 1 + insn.jf, false) - i - 1;
+        if (jt <= 255) {
+            insn.jt = static_cast<std::uint8_t>(jt);
+        }
+        if (jf <= 255) {
+            insn.jf = static_cast<std::uint8_t>(jf);
+        }
+        if (insn.jt == insn.jf) {
+            insn = BPF_JUMP(BPF_JMP | BPF_JA, insn.jt, 0, 0);
+        }
+    }
+}
+
+void eliminate_dead_code(Program& program)
+{
+    if (program.empty()) {
+        return;
+    }
+
+    std::vector<bool> live(program.size());
+    live[0] = true;
+    for (std::size_t i = 0 ; i < program.size() ; ++i) {
+        if (!live[i]) {
+            continue;
+        }
+        const auto& insn = program[i];
+        if (BPF_CLASS(insn.code) == BPF_RET) {
+            continue;
+        } else if (insn.code == (BPF_JMP | BPF_JA)) {
+            live.at(i + 1 + insn.k) = true;
+        } else if (is_conditional_jump(insn)) {
+            live.at(i + 1 + insn.jt) = true;
+            live.at(i + 1 + insn.jf) = true;
+        } else {
+            live.at(i + 1) = true;
+        }
+    }
+
+    // New index of each instruction. Removed instructions take the index of
+    // the next one kept, which is where jumps into them (only possible for
+    // `ja 0`) must land.
+    std::vector<std::size_t> index(program.size() + 1);
+    for (std::size_t i = 0 ; i < program.size() ; ++i) {
+        bool nop = program[i].code == (BPF_JMP | BPF_JA) && program[i].k == 0;
+        index[i + 1] = index[i] + (live[i] && !nop ? 1 : 0);
+    }
+
+    Program out;
+    out.reserve(index.back());
+    for (std::size_t i = 0 ; i < program.size() ; ++i) {
+        if (index[i + 1] == index[i]) {
+            continue;
+        }
+        auto insn = program[i];
+        auto offset = [&](std::size_t target) {
+            return index[i + 1 + target] - index[i] - 1;
+        };
+        if (insn.code == (BPF_JMP | BPF_JA)) {
+            insn.k = static_cast<std::uint32_t>(offset(insn.k));
+        } else if (is_conditional_jump(insn)) {
+            insn.jt = static_cast<std::uint8_t>(offset(insn.jt));
+            insn.jf = static_cast<std::uint8_t>(offset(insn.jf));
+        }
+        out.push_back(insn);
+    }
+    program = std::move(out);
+}
+
+} // namespace fekal::bpf
@@ -3,6 +3,7 @@
 
 #include <fekal/checker.hpp>
 #include <fekal/diagnostics.hpp>
+#include <fekal/uses.hpp>
 
 namespace fekal {
 
@@ -13,6 +14,7 @@ Checker check(
 {
     Checker checker{context, diagnostics};
     checker.traverse(ast);
+    UseResolver{ast}.check(diagnostics);
     return checker;
 }
 
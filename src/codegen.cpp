@@ -0,0 +1,904 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/codegen.hpp>
+#include <fekal/constants.hpp>
+#include <fekal/exprtable.hpp>
+#include <fekal/uses.hpp>
+#include <boost/hana/functional/overload.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cassert>
+#include <format>
+#include <ranges>
+#include <optional>
+#include <tuple>
+#include <map>
+#include <set>
+
+namespace fekal {
+
+namespace hana = boost::hana;
+
+namespace {
+
+// Byte offset of each 32-bit half within a 64-bit syscall argument (little
+// endian).
+enum class Half : unsigned
+{
+    LO = 0,
+    HI = 4,
+};
+
+constexpr std::uint32_t half_of(std::uint64_t v, Half h)
+{
+    return h == Half::LO ? static_cast<std::uint32_t>(v) :
+        static_cast<std::uint32_t>(v >> 32);
+}
+
+bool has_identifiers(const ast::IntExpr& e)
+{
+    return std::visit(hana::overload(
+        [](const ast::IntLit&) { return false; },
+        [](const ast::Identifier&) { return true; },
+        [](const auto& e) {
+            return has_identifiers(*e.left) || has_identifiers(*e.right); }
+    ), e);
+}
+
+// Builds the program back to front, so the targets of every jump are already
+// known by the time the jump is emitted. Classic BPF can only jump forward
+// and conditional jumps only reach 255 instructions ahead, so far targets get
+// a trampoline.
+//
+// Building back to front also means that code is fully described by its
+// instructions and the labels it continues to. Identical code (e.g. the same
+// predicate under several syscalls or archs) is emitted once and shared.
+class Emitter
+{
+public:
+    // Index into the reversed instruction list
+    using Label = std::size_t;
+
+    Label emit(sock_filter insn)
+    {
+        rinsns.push_back(insn);
+        return rinsns.size() - 1;
+    }
+
+    // Emits `snippet` (straight-line code) to fall through into `next`.
+    Label prepend(std::span<const sock_filter> snippet, Label next)
+    {
+        if (snippet.empty()) {
+            return next;
+        }
+
+        std::vector<std::uint64_t> key;
+        for (const auto& insn : snippet) {
+            key.push_back(pack(insn));
+        }
+        auto& shared = snippets[{std::move(key), next}];
+        if (shared && reusable(*shared, snippet.size())) {
+            return *shared;
+        }
+
+        next = fallthrough(next);
+        for (const auto& insn : std::views::reverse(snippet)) {
+            emit(insn);
+        }
+        shared = rinsns.size() - 1;
+        return *shared;
+    }
+
+    Label ret(std::uint32_t k)
+    {
+        if (auto it = rets.find(k) ; it != rets.end()) {
+            return it->second;
+        }
+        return rets[k] = emit(BPF_STMT(BPF_RET | BPF_K, k));
+    }
+
+    Label jump(std::uint16_t code, std::uint32_t k, Label jt, Label jf)
+    {
+        auto& shared = jumps[{code, k, jt, jf}];
+        if (shared && reusable(*shared, 1)) {
+            return *shared;
+        }
+        shared = emit_jump(code, k, jt, jf);
+        return *shared;
+    }
+
+    // Ensures the next instruction to be emitted will flow into `target`.
+    Label fallthrough(Label target)
+    {
+        if (!rinsns.empty() && target == rinsns.size() - 1) {
+            return target;
+        }
+        return trampoline(target);
+    }
+
+    std::size_t size() const
+    {
+        return rinsns.size();
+    }
+
+    bpf::Program program() const
+    {
+        return {rinsns.rbegin(), rinsns.rend()};
+    }
+
+private:
+    std::size_t distance(Label target) const
+    {
+        assert(target < rinsns.size());
+        return rinsns.size() - target - 1;
+    }
+
+    Label emit_jump(std::uint16_t code, std::uint32_t k, Label jt, Label jf)
+    {
+        for (;;) {
+            if (distance(jt) > 255) {
+                jt = trampoline(jt);
+                continue;
+            }
+            if (distance(jf) > 255) {
+                jf = trampoline(jf);
+                continue;
+            }
+            break;
+        }
+        return emit(BPF_JUMP(
+            code, k, static_cast<std::uint8_t>(distance(jt)),
+            static_cast<std::uint8_t>(distance(jf))));
+    }
+
+    // Reusing `size` instructions at `label` beats emitting a copy unless
+    // reaching them would take a trampoline as long as the copy
+    bool reusable(Label label, std::size_t size) const
+    {
+        return size > 1 || distance(label) < 255;
+    }
+
+    static std::uint64_t pack(const sock_filter& insn)
+    {
+        return std::uint64_t{insn.code} << 48 | std::uint64_t{insn.jt} << 40 |
+            std::uint64_t{insn.jf} << 32 | insn.k;
+    }
+
+    Label trampoline(Label target)
+    {
+        const auto& insn = rinsns[target];
+        if (insn.code == (BPF_RET | BPF_K)) {
+            // a copy is as cheap as a jump and exits one instruction earlier
+            return rets[insn.k] = emit(insn);
+        }
+        return emit(BPF_JUMP(
+            BPF_JMP | BPF_JA, static_cast<std::uint32_t>(distance(target)),
+            0, 0));
+    }
+
+    std::vector<sock_filter> rinsns;
+    std::unordered_map<std::uint32_t, Label> rets;
+    std::map<std::tuple<std::uint16_t, std::uint32_t, Label, Label>,
+             std::optional<Label>> jumps;
+    std::map<std::pair<std::vector<std::uint64_t>, Label>,
+             std::optional<Label>> snippets;
+};
+
+using Label = Emitter::Label;
+
+// Lowers the guards of one syscall filter for one arch.
+struct GuardLowering
+{
+    Emitter& e;
+    const Arch& arch;
+    const ast::SyscallFilter& filter;
+
+    Label guard(Label t, Label f)
+    {
+        auto l = f;
+        for (const auto& expr : std::views::reverse(filter.body)) {
+            l = cond(*expr, t, l);
+        }
+        return filter.body.empty() ? t : l;
+    }
+
+private:
+    Label cond(const ast::BoolExpr& expr, Label t, Label f)
+    {
+        if (t == f) {
+            return t;
+        }
+
+        // Outcome labels for (greater, equal, less) of left against right
+        return std::visit(hana::overload(
+            [&](const ast::EqExpr& e) {
+                return compare(*e.left, *e.right, f, t, f);
+            },
+            [&](const ast::NeqExpr& e) {
+                return compare(*e.left, *e.right, t, f, t);
+            },
+            [&](const ast::LtExpr& e) {
+                return compare(*e.left, *e.right, f, f, t);
+            },
+            [&](const ast::GtExpr& e) {
+                return compare(*e.left, *e.right, t, f, f);
+            },
+            [&](const ast::LteExpr& e) {
+                return compare(*e.left, *e.right, f, t, t);
+            },
+            [&](const ast::GteExpr& e) {
+                return compare(*e.left, *e.right, t, t, f);
+            },
+            [&](const ast::NegExpr& e) {
+                return cond(*e.inner, f, t);
+            },
+            [&](const ast::AndExpr& e) {
+                auto r = cond(*e.right, t, f);
+                return cond(*e.left, r, f);
+            },
+            [&](const ast::OrExpr& e) {
+                auto r = cond(*e.right, t, f);
+                return cond(*e.left, t, r);
+            }
+        ), expr);
+    }
+
+    // Unsigned 64-bit comparison done as two 32-bit comparisons. The low
+    // halves only decide the outcome when the high halves are equal.
+    Label compare(
+        const ast::IntExpr& left, const ast::IntExpr& right,
+        Label gt, Label eq, Label lt)
+    {
+        auto lo = three_way(left, right, Half::LO, gt, eq, lt);
+        return three_way(left, right, Half::HI, gt, lo, lt);
+    }
+
+    Label three_way(
+        const ast::IntExpr& left, const ast::IntExpr& right, Half h,
+        Label gt, Label eq, Label lt)
+    {
+        if (gt == eq && eq == lt) {
+            return gt;
+        }
+
+        auto kl = known_half(left, h);
+        auto kr = known_half(right, h);
+        if (kl && kr) {
+            return *kl > *kr ? gt : *kl == *kr ? eq : lt;
+        }
+
+        const ast::IntExpr* a = &left;
+        const ast::IntExpr* b = &right;
+        if (kl) {
+            // keep the unknown value in the accumulator
+            std::swap(a, b);
+            std::swap(kl, kr);
+            std::swap(gt, lt);
+        }
+
+        std::vector<sock_filter> snippet;
+        std::uint16_t src = BPF_K;
+        std::uint32_t k = 0;
+        if (kr) {
+            load_half(*a, h, 0, snippet);
+            k = *kr;
+        } else {
+            std::vector<sock_filter> snippet_a;
+            load_half(*a, h, 1, snippet_a);
+            load_half(*b, h, 1, snippet);
+            bool clobbers_x = std::ranges::any_of(snippet_a, [](auto& insn) {
+                return insn.code == (BPF_LDX | BPF_MEM);
+            });
+            if (clobbers_x) {
+                snippet.push_back(BPF_STMT(BPF_ST, 0));
+                snippet.insert(snippet.end(), snippet_a.begin(), snippet_a.end());
+                snippet.push_back(BPF_STMT(BPF_LDX | BPF_MEM, 0));
+            } else {
+                snippet.push_back(BPF_STMT(BPF_MISC | BPF_TAX, 0));
+                snippet.insert(snippet.end(), snippet_a.begin(), snippet_a.end());
+            }
+            src = BPF_X;
+        }
+
+        Label l;
+        if (gt == eq) {
+            l = e.jump(BPF_JMP | BPF_JGE | src, k, gt, lt);
+        } else if (eq == lt) {
+            l = e.jump(BPF_JMP | BPF_JGT | src, k, gt, lt);
+        } else if (gt == lt) {
+            l = e.jump(BPF_JMP | BPF_JEQ | src, k, eq, gt);
+        } else {
+            auto mid = e.jump(BPF_JMP | BPF_JEQ | src, k, eq, lt);
+            l = e.jump(BPF_JMP | BPF_JGT | src, k, gt, mid);
+        }
+        return e.prepend(snippet, l);
+    }
+
+    std::optional<std::size_t> param_index(const ast::Identifier& id) const
+    {
+        for (std::size_t i = 0 ; i < filter.params.size() ; ++i) {
+            if (filter.params[i].value == id.value) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Bits of a half that can be determined at compile time.
+    std::optional<std::uint32_t> known_half(const ast::IntExpr& expr, Half h)
+    {
+        if (!has_identifiers(expr)) {
+            return half_of(eval(expr), h);
+        }
+
+        using R = std::optional<std::uint32_t>;
+        return std::visit(hana::overload(
+            [&](const ast::Identifier&) -> R {
+                if (h == Half::HI && !arch.is_64bit) {
+                    return 0;
+                }
+                return std::nullopt;
+            },
+            [&](const ast::BitAndExpr& e) -> R {
+                auto l = known_half(*e.left, h);
+                auto r = known_half(*e.right, h);
+                if (l && r) {
+                    return *l & *r;
+                } else if (l == 0u || r == 0u) {
+                    return 0;
+                }
+                return std::nullopt;
+            },
+            [&](const ast::BitOrExpr& e) -> R {
+                auto l = known_half(*e.left, h);
+                auto r = known_half(*e.right, h);
+                if (l && r) {
+                    return *l | *r;
+                } else if (l == 0xffffffffu || r == 0xffffffffu) {
+                    return 0xffffffff;
+                }
+                return std::nullopt;
+            },
+            [&](const ast::BitXorExpr& e) -> R {
+                auto l = known_half(*e.left, h);
+                auto r = known_half(*e.right, h);
+                if (l && r) {
+                    return *l ^ *r;
+                }
+                return std::nullopt;
+            },
+            [](const auto&) -> R { return std::nullopt; }
+        ), expr);
+    }
+
+    // Appends code leaving the half of `expr` in the accumulator. Scratch
+    // memory from slot `depth` onwards may be used.
+    void load_half(
+        const ast::IntExpr& expr, Half h, unsigned depth,
+        std::vector<sock_filter>& out)
+    {
+        if (auto k = known_half(expr, h) ; k) {
+            out.push_back(BPF_STMT(BPF_LD | BPF_IMM, *k));
+            return;
+        }
+
+        auto binop = [&](std::uint16_t op, const auto& e) {
+            if (auto k = known_half(*e.right, h) ; k) {
+                load_half(*e.left, h, depth, out);
+                out.push_back(BPF_STMT(BPF_ALU | op | BPF_K, *k));
+            } else if (auto k = known_half(*e.left, h) ; k) {
+                load_half(*e.right, h, depth, out);
+                out.push_back(BPF_STMT(BPF_ALU | op | BPF_K, *k));
+            } else {
+                // validated against BPF_MEMWORDS beforehand
+                load_half(*e.right, h, depth, out);
+                out.push_back(BPF_STMT(BPF_ST, depth));
+                load_half(*e.left, h, depth + 1, out);
+                out.push_back(BPF_STMT(BPF_LDX | BPF_MEM, depth));
+                out.push_back(BPF_STMT(BPF_ALU | op | BPF_X, 0));
+            }
+        };
+
+        std::visit(hana::overload(
+            [&](const ast::Identifier& id) {
+                auto idx = param_index(id);
+                assert(idx);
+                auto offset = offsetof(seccomp_data, args) + *idx * 8 +
+                    static_cast<unsigned>(h);
+                out.push_back(BPF_STMT(
+                    BPF_LD | BPF_W | BPF_ABS,
+                    static_cast<std::uint32_t>(offset)));
+            },
+            [&](const ast::BitAndExpr& e) { binop(BPF_AND, e); },
+            [&](const ast::BitOrExpr& e) { binop(BPF_OR, e); },
+            [&](const ast::BitXorExpr& e) { binop(BPF_XOR, e); },
+            [](const auto&) {
+                // validated beforehand
+                assert(false);
+            }
+        ), expr);
+    }
+};
+
+// Rejects what can't be lowered before any code is emitted.
+struct Validator : Traverser<Validator>
+{
+    Validator(Diagnostics& diagnostics) : diagnostics{diagnostics} {}
+
+    bool visit(const ast::SyscallFilter& filter)
+    {
+        if (filter.params.size() > 6) {
+            diagnostics.error(
+                std::format(
+                    "Syscall `{}` takes at most 6 parameters", filter.syscall),
+                diagnostics.rangeFromName(filter, filter.syscall));
+        }
+        current = &filter;
+        for (const auto& expr : filter.body) {
+            check(*expr);
+        }
+        return false;
+    }
+
+    // Divisors that depend on the arch are only known once resolved for it
+    void check_divisors(const ast::SyscallFilter& filter, const Arch& arch)
+    {
+        for (const auto& expr : filter.body) {
+            check_divisors(*expr, arch);
+        }
+    }
+
+    Diagnostics& diagnostics;
+
+private:
+    void check_divisors(const ast::BoolExpr& expr, const Arch& arch)
+    {
+        std::visit(hana::overload(
+            [&](const ast::NegExpr& e) { check_divisors(*e.inner, arch); },
+            [&](const auto& e) {
+                check_divisors(*e.left, arch);
+                check_divisors(*e.right, arch);
+            }
+        ), expr);
+    }
+
+    void check_divisors(const ast::IntExpr& expr, const Arch& arch)
+    {
+        std::visit(hana::overload(
+            [](const ast::IntLit&) {},
+            [](const ast::Identifier&) {},
+            [&]<class T>(const T& e) {
+                auto lit = std::get_if<ast::IntLit>(&*e.right);
+                if (std::is_same_v<T, ast::DivExpr> && lit && lit->value == 0) {
+                    diagnostics.error(
+                        std::format("Division by zero on {}", arch.name),
+                        diagnostics.rangeFromName(e, ""));
+                    return;
+                }
+                check_divisors(*e.left, arch);
+                check_divisors(*e.right, arch);
+            }
+        ), expr);
+    }
+
+    void check(const ast::BoolExpr& expr)
+    {
+        std::visit(hana::overload(
+            [&](const ast::NegExpr& e) { check(*e.inner); },
+            [&](const ast::AndExpr& e) { check(*e.left); check(*e.right); },
+            [&](const ast::OrExpr& e) { check(*e.left); check(*e.right); },
+            [&](const auto& e) {
+                check(*e.left, 0);
+                check(*e.right, 0);
+            }
+        ), expr);
+    }
+
+    void check(const ast::IntExpr& expr, unsigned depth)
+    {
+        auto bitwise = [&](const auto& e) {
+            if (depth + 1 >= BPF_MEMWORDS) {
+                diagnostics.error(
+                    "Expression too deep to be lowered",
+                    diagnostics.rangeFromName(e, ""));
+                return;
+            }
+            check(*e.left, depth + 1);
+            check(*e.right, depth + 1);
+        };
+        auto arithmetic = [&](const auto& e) {
+            if (has_arguments(expr)) {
+                diagnostics.error(
+                    "Only bitwise operators may be applied to syscall "
+                    "arguments",
+                    diagnostics.rangeFromName(e, ""));
+                return;
+            }
+        };
+
+        std::visit(hana::overload(
+            [&](const ast::IntLit&) {},
+            [&](const ast::Identifier& id) {
+                if (!is_param(id) && !depends_on_arch(id.value)) {
+                    diagnostics.error(
+                        std::format("Unknown identifier `{}`", id.value),
+                        diagnostics.rangeFromName(id, id.value));
+                }
+            },
+            [&](const ast::BitAndExpr& e) { bitwise(e); },
+            [&](const ast::BitOrExpr& e) { bitwise(e); },
+            [&](const ast::BitXorExpr& e) { bitwise(e); },
+            [&](const ast::DivExpr& e) {
+                arithmetic(e);
+                if (!has_identifiers(*e.right) && eval(*e.right) == 0) {
+                    diagnostics.error(
+                        "Division by zero", diagnostics.rangeFromName(e, ""));
+                }
+            },
+            [&](const auto& e) { arithmetic(e); }
+        ), expr);
+    }
+
+    bool is_param(const ast::Identifier& id) const
+    {
+        auto it = std::ranges::find(
+            current->params, id.value, &ast::Identifier::value);
+        return it != current->params.end() && id.value != "_";
+    }
+
+    // Constants with a value per arch are only resolved once the arch is
+    // known, but they aren't syscall arguments
+    bool has_arguments(const ast::IntExpr& expr) const
+    {
+        return std::visit(hana::overload(
+            [](const ast::IntLit&) { return false; },
+            [&](const ast::Identifier& id) {
+                return is_param(id) || !depends_on_arch(id.value);
+            },
+            [&](const auto& e) {
+                return has_arguments(*e.left) || has_arguments(*e.right);
+            }
+        ), expr);
+    }
+
+    const ast::SyscallFilter* current = nullptr;
+};
+
+struct Rule
+{
+    const ast::Action* action;
+    const ast::SyscallFilter* filter;
+};
+
+// Collects the rules that make up the program, expanding USE statements.
+struct Flattener
+{
+    Flattener(const UseResolver& resolver) : resolver{resolver} {}
+
+    void add(const ast::ActionBlock& block)
+    {
+        for (const auto& filter : block.filters) {
+            rules[filter.syscall].push_back(Rule{&block.action, &filter});
+        }
+    }
+
+    void add(const ast::UseStatement& stmt)
+    {
+        // policies reached before this statement contribute nothing
+        std::vector<const ast::Policy*> reached;
+        for (const auto& e : *resolver.resolve(stmt.key())) {
+            if (!included.contains(e.policy)) {
+                add(*e.block);
+                reached.push_back(e.policy);
+            }
+        }
+        included.insert(reached.begin(), reached.end());
+    }
+
+    // Keyed by syscall name, which the AST owns
+    std::map<std::string_view, std::vector<Rule>> rules;
+
+private:
+    const UseResolver& resolver;
+    std::unordered_set<const ast::Policy*> included;
+};
+
+struct Interval
+{
+    std::uint32_t lo;
+    std::uint32_t hi;
+    Label label;
+};
+
+// Dispatches on the syscall number held in the accumulator. Numbers outside
+// every interval go to `miss`.
+Label dispatch(
+    Emitter& e, std::span<const Interval> intervals, Label miss, bool binary)
+{
+    if (binary && intervals.size() > 4) {
+        auto mid = intervals.size() / 2;
+        auto hi = dispatch(e, intervals.subspan(mid), miss, binary);
+        auto lo = dispatch(e, intervals.first(mid), miss, binary);
+        return e.jump(BPF_JMP | BPF_JGE | BPF_K, intervals[mid].lo, hi, lo);
+    }
+
+    auto l = miss;
+    for (const auto& i : std::views::reverse(intervals)) {
+        if (i.lo == i.hi) {
+            l = e.jump(BPF_JMP | BPF_JEQ | BPF_K, i.lo, i.label, l);
+        } else {
+            auto in = e.jump(BPF_JMP | BPF_JGT | BPF_K, i.hi, l, i.label);
+            l = e.jump(BPF_JMP | BPF_JGE | BPF_K, i.lo, in, l);
+        }
+    }
+    return l;
+}
+
+} // namespace
+
+ir::DecisionTable lower(
+    Diagnostics& diagnostics,
+    const std::vector<ast::ProgramStatement>& ast,
+    std::span<const Arch> archs)
+{
+    UseResolver resolver{ast};
+    Flattener flattener{resolver};
+    std::optional<ast::DefaultAction> default_action;
+    for (const auto& stmt : ast) {
+        std::visit(hana::overload(
+            [](const ast::Policy&) {},
+            [&](const ast::DefaultAction& action) {
+                if (default_action) {
+                    diagnostics.error(
+                        "DEFAULT action already declared",
+                        diagnostics.rangeFromName(action, "DEFAULT"));
+                }
+                default_action.emplace(action);
+            },
+            [&](const auto& stmt) { flattener.add(stmt); }
+        ), stmt);
+    }
+
+    ir::DecisionTable table;
+    table.default_action = default_action ?
+        ir::action_value(*default_action) : SECCOMP_RET_KILL_PROCESS;
+    for (const auto& arch : archs) {
+        table.archs.push_back(ir::ArchTable{arch, {}});
+    }
+
+    // Guards are copies, so folding and interning leave the AST as written.
+    // Identical expressions across the program become one node from here on.
+    // Folding builds in the table's arena too, so the guards of the table
+    // keep a single arena alive besides the AST's.
+    ExprTable exprs;
+    ast::ArenaScope arena{exprs.arena()};
+    auto intern = [&](ir::Guard& guard) {
+        for (auto& expr : guard.body) {
+            expr = exprs.intern(expr);
+        }
+    };
+
+    Validator validator{diagnostics};
+    for (const auto& [syscall, rules] : flattener.rules) {
+        std::vector<ir::Entry> entries;
+        for (const auto& rule : rules) {
+            ir::Guard guard = *rule.filter;
+            fold_constants(guard);
+            intern(guard);
+            validator.traverse(guard);
+            entries.push_back(
+                ir::Entry{
+                    std::move(guard), ir::action_value(*rule.action),
+                    rule.filter->body});
+        }
+        std::ranges::stable_sort(
+            entries, std::greater{}, [](const ir::Entry& e) {
+                return ir::precedence(e.action);
+            });
+
+        bool known = false;
+        for (auto& t : table.archs) {
+            if (auto nr = resolve_syscall(t.arch, syscall) ; nr) {
+                // what's left are the constants whose value depends on arch
+                auto resolved = entries;
+                for (auto& e : resolved) {
+                    auto body = e.guard.body;
+                    fold_constants(e.guard, &t.arch);
+                    if (e.guard.body != body) {
+                        intern(e.guard);
+                        validator.check_divisors(e.guard, t.arch);
+                    }
+                }
+                t.syscalls.emplace(
+                    *nr, ir::Syscall{std::string{syscall}, std::move(resolved)});
+                known = true;
+            }
+        }
+        if (!known) {
+            const auto& filter = *rules.front().filter;
+            diagnostics.warning(
+                std::format("Unknown syscall `{}` ignored", syscall),
+                diagnostics.rangeFromName(filter, syscall));
+        }
+    }
+
+    return table;
+}
+
+// Whether parameter names agree on the positions both lists declare, so
+// expressions of either guard mean the same under the longer list
+static bool compatible(
+    const ast::SyscallParameters& a, const ast::SyscallParameters& b)
+{
+    auto n = std::min(a.size(), b.size());
+    return std::ranges::equal(
+        a | std::views::take(n), b | std::views::take(n), {},
+        &ast::Identifier::value, &ast::Identifier::value);
+}
+
+void eliminate_redundant_rules(
+    Diagnostics& diagnostics, ir::DecisionTable& table)
+{
+    // Archs share the rules of the same source
+    std::set<std::pair<unsigned, unsigned>> reported;
+    auto drop = [&](const ir::Entry& entry, std::string_view reason) {
+        const auto& guard = entry.guard;
+        if (reported.emplace(guard.line, guard.column).second) {
+            diagnostics.hint(
+                std::format("Rule for `{}` dropped: {}", guard.syscall, reason),
+                diagnostics.rangeFromName(guard, guard.syscall));
+        }
+    };
+
+    for (auto& t : table.archs) {
+        for (auto& [nr, syscall] : t.syscalls) {
+            std::vector<ir::Entry> kept;
+            for (auto& entry : syscall.entries) {
+                if (!kept.empty() && kept.back().unconditional()) {
+                    drop(entry, "shadowed by an unconditional rule");
+                    continue;
+                }
+
+                auto& guard = entry.guard;
+                if (entry.unconditional()) {
+                    while (!kept.empty() && kept.back().action == entry.action) {
+                        drop(kept.back(), "subsumed by an unconditional rule");
+                        kept.pop_back();
+                    }
+                    kept.push_back(std::move(entry));
+                    continue;
+                }
+
+                // alternatives already matched by earlier rules never get here
+                auto removed = std::erase_if(guard.body, [&](const auto& expr) {
+                    return std::ranges::any_of(kept, [&](const auto& k) {
+                        return compatible(k.guard.params, guard.params) &&
+                            std::ranges::any_of(
+                                k.guard.body, [&](const auto& e) {
+                                    return equivalent(*e, *expr);
+                                });
+                    });
+                });
+                if (guard.body.empty()) {
+                    drop(entry, "covered by earlier rules");
+                    continue;
+                }
+                if (removed != 0) {
+                    entry.written.clear();
+                }
+
+                if (
+                    !kept.empty() && kept.back().action == entry.action &&
+                    compatible(kept.back().guard.params, guard.params)
+                ) {
+                    auto& merged = kept.back().guard;
+                    if (guard.params.size() > merged.params.size()) {
+                        merged.params = guard.params;
+                    }
+                    merged.body.insert(
+                        merged.body.end(), guard.body.begin(),
+                        guard.body.end());
+                    kept.back().written.clear();
+                    continue;
+                }
+                kept.push_back(std::move(entry));
+            }
+            syscall.entries = std::move(kept);
+        }
+    }
+}
+
+void prune_rules(ir::DecisionTable& table)
+{
+    for (auto& t : table.archs) {
+        for (auto it = t.syscalls.begin() ; it != t.syscalls.end() ;) {
+            auto& entries = it->second.entries;
+            auto u = std::ranges::find_if(entries, &ir::Entry::unconditional);
+            if (u != entries.end()) {
+                entries.erase(u + 1, entries.end());
+            }
+
+            // nothing to dispatch if the outcome equals the default
+            if (
+                entries.size() == 1 && entries.front().unconditional() &&
+                entries.front().action == table.default_action
+            ) {
+                it = t.syscalls.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+bpf::Program emit(
+    Diagnostics& diagnostics,
+    const ir::DecisionTable& table,
+    const CodegenOptions& options)
+{
+    Emitter e;
+    std::vector<Label> sections;
+    for (const auto& [arch, syscalls] : std::views::reverse(table.archs)) {
+        std::vector<Interval> intervals;
+        for (const auto& [nr, syscall] : std::views::reverse(syscalls)) {
+            auto l = e.ret(table.default_action);
+            for (const auto& entry : std::views::reverse(syscall.entries)) {
+                GuardLowering lowering{e, arch, entry.guard};
+                l = lowering.guard(e.ret(entry.action), l);
+            }
+            if (
+                options.coalesce_ranges && !intervals.empty() &&
+                intervals.back().lo == nr + 1 && intervals.back().label == l
+            ) {
+                intervals.back().lo = nr;
+                continue;
+            }
+            intervals.push_back(Interval{nr, nr, l});
+        }
+        std::ranges::reverse(intervals);
+
+        auto l = dispatch(
+            e, intervals, e.ret(table.default_action),
+            options.binary_dispatch);
+        if (arch.foreign_abi_bit != 0) {
+            l = e.jump(
+                BPF_JMP | BPF_JGE | BPF_K, arch.foreign_abi_bit,
+                e.ret(SECCOMP_RET_KILL_PROCESS), l);
+        }
+        if (!intervals.empty() || arch.foreign_abi_bit != 0) {
+            e.fallthrough(l);
+            l = e.emit(BPF_STMT(
+                BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, nr)));
+        }
+        sections.push_back(l);
+    }
+
+    // sections were emitted in reverse order
+    auto l = e.ret(SECCOMP_RET_KILL_PROCESS);
+    for (std::size_t i = 0 ; i < sections.size() ; ++i) {
+        const auto& arch = table.archs[sections.size() - 1 - i].arch;
+        l = e.jump(BPF_JMP | BPF_JEQ | BPF_K, arch.token, sections[i], l);
+    }
+    if (!sections.empty()) {
+        e.fallthrough(l);
+        e.emit(BPF_STMT(
+            BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, arch)));
+    }
+
+    if (e.size() > BPF_MAXINSNS) {
+        diagnostics.error(
+            std::format(
+                "Generated filter has {} instructions, more than the {} "
+                "accepted by the kernel", e.size(), BPF_MAXINSNS),
+            Range{});
+        return {};
+    }
+
+    return e.program();
+}
+
+} // namespace fekal
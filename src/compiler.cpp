@@ -4,7 +4,8 @@
 #include <fekal/compiler.hpp>
 #include <fekal/checker.hpp>
 #include <fekal/parser.hpp>
-#include <fekal/checker/syscalls/open.hpp>
+#include <fekal/codegen.hpp>
+#include <fekal/uses.hpp>
 
 namespace fekal {
 
@@ -14,6 +15,7 @@ void Compiler::reset()
 {
     context.reset();
     diagnostics.reset();
+    passes.timings.clear();
 }
 
 void Compiler::print_errors()
@@ -23,16 +25,59 @@ void Compiler::print_errors()
 
 std::vector<ast::ProgramStatement> Compiler::compile(const std::string_view source)
 {
-    auto ast = fekal::parse(source);
+    auto ast = fekal::parse(source, passes.jobs);
+    if (!check_all) {
+        auto reachable = UseResolver{ast}.reachable();
+        for (const auto& stmt : ast) {
+            auto policy = std::get_if<ast::Policy>(&stmt);
+            if (policy && !reachable.contains(policy)) {
+                context.unreachable.insert(policy);
+            }
+        }
+    }
     fekal::check(context, diagnostics, ast);
     compile_rules(ast);
     return ast;
 }
 
-void Compiler::compile_rules(const std::vector<ast::ProgramStatement>& ast)
+void Compiler::compile_rules(std::vector<ast::ProgramStatement>& ast)
 {
-    auto syscallOpen = fekal::rules::SyscallOpen{context, diagnostics};
-    syscallOpen.check(ast);
+    passes.run(context, diagnostics, ast);
+}
+
+bpf::Program Compiler::codegen(
+    const std::vector<ast::ProgramStatement>& ast,
+    std::span<const Arch> archs)
+{
+    if (diagnostics.has_errors()) {
+        return {};
+    }
+
+    auto timed = [&](std::string_view name, auto f) {
+        auto start = std::chrono::steady_clock::now();
+        auto ret = f();
+        if (passes.time_passes) {
+            passes.timings.push_back(PassManager::Timing{
+                std::string{name}, std::chrono::steady_clock::now() - start});
+        }
+        return ret;
+    };
+
+    auto table = timed("lower", [&]() {
+        return fekal::lower(diagnostics, ast, archs);
+    });
+    if (diagnostics.has_errors()) {
+        return {};
+    }
+    passes.run(diagnostics, table);
+
+    auto program = timed("emit", [&]() {
+        return fekal::emit(diagnostics, table, passes.codegen_options());
+    });
+    if (!program.empty()) {
+        passes.run(program);
+    }
+    return program;
 }
 
 } // namespace fekal
@@ -0,0 +1,476 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/constants.hpp>
+#include <boost/hana/functional/overload.hpp>
+#include <linux/audit.h>
+#include <algorithm>
+#include <array>
+
+namespace fekal {
+
+namespace hana = boost::hana;
+
+namespace {
+
+template<std::size_t N>
+constexpr std::array<Constant, N> sorted(std::array<Constant, N> table)
+{
+    std::ranges::sort(table, {}, &Constant::name);
+    return table;
+}
+
+template<std::size_t N>
+constexpr bool unique(const std::array<Constant, N>& table)
+{
+    return std::ranges::adjacent_find(
+        table, {}, &Constant::name) == table.end();
+}
+
+constexpr std::optional<std::uint64_t> find(
+    std::span<const Constant> table, std::string_view name)
+{
+    auto it = std::ranges::lower_bound(table, name, {}, &Constant::name);
+    if (it == table.end() || it->name != name) {
+        return std::nullopt;
+    }
+    return it->value;
+}
+
+constexpr auto table = sorted(std::to_array<Constant>({
+    // open()
+    {"O_RDONLY", 0},
+    {"O_WRONLY", 01},
+    {"O_RDWR", 02},
+    {"O_ACCMODE", 03},
+    {"O_CREAT", 0100},
+    {"O_EXCL", 0200},
+    {"O_NOCTTY", 0400},
+    {"O_TRUNC", 01000},
+    {"O_APPEND", 02000},
+    {"O_NONBLOCK", 04000},
+    {"O_NDELAY", 04000},
+    {"O_DSYNC", 010000},
+    {"O_ASYNC", 020000},
+    {"O_DIRECT", 040000},
+    {"O_LARGEFILE", 0100000},
+    {"O_DIRECTORY", 0200000},
+    {"O_NOFOLLOW", 0400000},
+    {"O_NOATIME", 01000000},
+    {"O_CLOEXEC", 02000000},
+    {"O_SYNC", 04010000},
+    {"O_RSYNC", 04010000},
+    {"O_PATH", 010000000},
+    {"O_TMPFILE", 020200000},
+
+    // socket() domains
+    {"AF_UNSPEC", 0},
+    {"AF_UNIX", 1},
+    {"AF_LOCAL", 1},
+    {"AF_INET", 2},
+    {"AF_AX25", 3},
+    {"AF_IPX", 4},
+    {"AF_APPLETALK", 5},
+    {"AF_BRIDGE", 7},
+    {"AF_X25", 9},
+    {"AF_INET6", 10},
+    {"AF_KEY", 15},
+    {"AF_NETLINK", 16},
+    {"AF_PACKET", 17},
+    {"AF_RDS", 21},
+    {"AF_LLC", 26},
+    {"AF_IB", 27},
+    {"AF_MPLS", 28},
+    {"AF_CAN", 29},
+    {"AF_TIPC", 30},
+    {"AF_BLUETOOTH", 31},
+    {"AF_ALG", 38},
+    {"AF_NFC", 39},
+    {"AF_VSOCK", 40},
+    {"AF_KCM", 41},
+    {"AF_QIPCRTR", 42},
+    {"AF_SMC", 43},
+    {"AF_XDP", 44},
+    {"AF_MCTP", 45},
+
+    // socket() types and flags
+    {"SOCK_STREAM", 1},
+    {"SOCK_DGRAM", 2},
+    {"SOCK_RAW", 3},
+    {"SOCK_RDM", 4},
+    {"SOCK_SEQPACKET", 5},
+    {"SOCK_DCCP", 6},
+    {"SOCK_PACKET", 10},
+    {"SOCK_NONBLOCK", 04000},
+    {"SOCK_CLOEXEC", 02000000},
+
+    // personality()
+    {"UNAME26", 0x0020000},
+    {"ADDR_NO_RANDOMIZE", 0x0040000},
+    {"FDPIC_FUNCPTRS", 0x0080000},
+    {"MMAP_PAGE_ZERO", 0x0100000},
+    {"ADDR_COMPAT_LAYOUT", 0x0200000},
+    {"READ_IMPLIES_EXEC", 0x0400000},
+    {"ADDR_LIMIT_32BIT", 0x0800000},
+    {"SHORT_INODE", 0x1000000},
+    {"WHOLE_SECONDS", 0x2000000},
+    {"STICKY_TIMEOUTS", 0x4000000},
+    {"ADDR_LIMIT_3GB", 0x8000000},
+    {"PER_LINUX", 0x0000},
+    {"PER_LINUX_32BIT", 0x0800000},
+    {"PER_LINUX_FDPIC", 0x0080000},
+    {"PER_SVR4", 0x4100001},
+    {"PER_SVR3", 0x5000002},
+    {"PER_SCOSVR3", 0x7000003},
+    {"PER_OSR5", 0x6000003},
+    {"PER_WYSEV386", 0x5000004},
+    {"PER_ISCR4", 0x4000005},
+    {"PER_BSD", 0x0006},
+    {"PER_SUNOS", 0x4000006},
+    {"PER_XENIX", 0x5000007},
+    {"PER_LINUX32", 0x0008},
+    {"PER_LINUX32_3GB", 0x8000008},
+    {"PER_IRIX32", 0x4000009},
+    {"PER_IRIXN32", 0x400000a},
+    {"PER_IRIX64", 0x400000b},
+    {"PER_RISCOS", 0x000c},
+    {"PER_SOLARIS", 0x400000d},
+    {"PER_UW7", 0x410000e},
+    {"PER_OSF4", 0x000f},
+    {"PER_HPUX", 0x0010},
+    {"PER_MASK", 0x00ff},
+
+    // clone() and unshare()
+    {"CLONE_NEWTIME", 0x80},
+    {"CLONE_VM", 0x100},
+    {"CLONE_FS", 0x200},
+    {"CLONE_FILES", 0x400},
+    {"CLONE_SIGHAND", 0x800},
+    {"CLONE_PIDFD", 0x1000},
+    {"CLONE_PTRACE", 0x2000},
+    {"CLONE_VFORK", 0x4000},
+    {"CLONE_PARENT", 0x8000},
+    {"CLONE_THREAD", 0x10000},
+    {"CLONE_NEWNS", 0x20000},
+    {"CLONE_SYSVSEM", 0x40000},
+    {"CLONE_SETTLS", 0x80000},
+    {"CLONE_PARENT_SETTID", 0x100000},
+    {"CLONE_CHILD_CLEARTID", 0x200000},
+    {"CLONE_DETACHED", 0x400000},
+    {"CLONE_UNTRACED", 0x800000},
+    {"CLONE_CHILD_SETTID", 0x1000000},
+    {"CLONE_NEWCGROUP", 0x2000000},
+    {"CLONE_NEWUTS", 0x4000000},
+    {"CLONE_NEWIPC", 0x8000000},
+    {"CLONE_NEWUSER", 0x10000000},
+    {"CLONE_NEWPID", 0x20000000},
+    {"CLONE_NEWNET", 0x40000000},
+    {"CLONE_IO", 0x80000000},
+    {"CLONE_CLEAR_SIGHAND", 0x100000000},
+    {"CLONE_INTO_CGROUP", 0x200000000},
+}));
+static_assert(unique(table));
+
+// open() flags on arm and arm64, which don't follow the generic ABI for these
+constexpr auto arm_table = sorted(std::to_array<Constant>({
+    {"O_DIRECTORY", 040000},
+    {"O_NOFOLLOW", 0100000},
+    {"O_DIRECT", 0200000},
+    {"O_LARGEFILE", 0400000},
+    {"O_TMPFILE", 020040000},
+}));
+
+struct ArchConstants
+{
+    // AUDIT_ARCH_* value
+    std::uint32_t token;
+
+    // Replaces the entries of `table` with the same name
+    std::span<const Constant> values;
+};
+
+constexpr std::array arch_tables{
+    ArchConstants{AUDIT_ARCH_AARCH64, arm_table},
+    ArchConstants{AUDIT_ARCH_ARM, arm_table},
+};
+
+constexpr bool overrides_known_names()
+{
+    return std::ranges::all_of(arch_tables, [](const ArchConstants& t) {
+        return std::ranges::all_of(t.values, [](const Constant& c) {
+            return find(table, c.name).has_value();
+        });
+    });
+}
+static_assert(overrides_known_names());
+
+constexpr auto errnos = sorted(std::to_array<Constant>({
+    {"EPERM", 1},
+    {"ENOENT", 2},
+    {"ESRCH", 3},
+    {"EINTR", 4},
+    {"EIO", 5},
+    {"ENXIO", 6},
+    {"E2BIG", 7},
+    {"ENOEXEC", 8},
+    {"EBADF", 9},
+    {"ECHILD", 10},
+    {"EAGAIN", 11},
+    {"EWOULDBLOCK", 11},
+    {"ENOMEM", 12},
+    {"EACCES", 13},
+    {"EFAULT", 14},
+    {"ENOTBLK", 15},
+    {"EBUSY", 16},
+    {"EEXIST", 17},
+    {"EXDEV", 18},
+    {"ENODEV", 19},
+    {"ENOTDIR", 20},
+    {"EISDIR", 21},
+    {"EINVAL", 22},
+    {"ENFILE", 23},
+    {"EMFILE", 24},
+    {"ENOTTY", 25},
+    {"ETXTBSY", 26},
+    {"EFBIG", 27},
+    {"ENOSPC", 28},
+    {"ESPIPE", 29},
+    {"EROFS", 30},
+    {"EMLINK", 31},
+    {"EPIPE", 32},
+    {"EDOM", 33},
+    {"ERANGE", 34},
+    {"EDEADLK", 35},
+    {"ENAMETOOLONG", 36},
+    {"ENOLCK", 37},
+    {"ENOSYS", 38},
+    {"ENOTEMPTY", 39},
+    {"ELOOP", 40},
+    {"ENOMSG", 42},
+    {"EIDRM", 43},
+    {"ENOSTR", 60},
+    {"ENODATA", 61},
+    {"ETIME", 62},
+    {"ENOSR", 63},
+    {"ENOLINK", 67},
+    {"EPROTO", 71},
+    {"EMULTIHOP", 72},
+    {"EBADMSG", 74},
+    {"EOVERFLOW", 75},
+    {"EBADFD", 77},
+    {"EILSEQ", 84},
+    {"ERESTART", 85},
+    {"EUSERS", 87},
+    {"ENOTSOCK", 88},
+    {"EDESTADDRREQ", 89},
+    {"EMSGSIZE", 90},
+    {"EPROTOTYPE", 91},
+    {"ENOPROTOOPT", 92},
+    {"EPROTONOSUPPORT", 93},
+    {"ESOCKTNOSUPPORT", 94},
+    {"EOPNOTSUPP", 95},
+    {"ENOTSUP", 95},
+    {"EPFNOSUPPORT", 96},
+    {"EAFNOSUPPORT", 97},
+    {"EADDRINUSE", 98},
+    {"EADDRNOTAVAIL", 99},
+    {"ENETDOWN", 100},
+    {"ENETUNREACH", 101},
+    {"ENETRESET", 102},
+    {"ECONNABORTED", 103},
+    {"ECONNRESET", 104},
+    {"ENOBUFS", 105},
+    {"EISCONN", 106},
+    {"ENOTCONN", 107},
+    {"ESHUTDOWN", 108},
+    {"ETOOMANYREFS", 109},
+    {"ETIMEDOUT", 110},
+    {"ECONNREFUSED", 111},
+    {"EHOSTDOWN", 112},
+    {"EHOSTUNREACH", 113},
+    {"EALREADY", 114},
+    {"EINPROGRESS", 115},
+    {"ESTALE", 116},
+    {"EREMOTEIO", 121},
+    {"EDQUOT", 122},
+    {"ENOMEDIUM", 123},
+    {"EMEDIUMTYPE", 124},
+    {"ECANCELED", 125},
+    {"ENOKEY", 126},
+    {"EKEYEXPIRED", 127},
+    {"EKEYREVOKED", 128},
+    {"EKEYREJECTED", 129},
+    {"EOWNERDEAD", 130},
+    {"ENOTRECOVERABLE", 131},
+    {"ERFKILL", 132},
+    {"EHWPOISON", 133},
+}));
+static_assert(unique(errnos));
+
+static_assert(find(table, "O_CLOEXEC") == 02000000);
+static_assert(!find(table, "O_"));
+
+// Nodes are never modified. A subtree that folds to something else is
+// rebuilt, and everything else is returned as is.
+struct Folder
+{
+    const ast::SyscallParameters& params;
+
+    // Constants with a value per arch stay unfolded without one
+    const Arch* arch;
+
+    std::optional<std::uint64_t> constant(std::string_view name) const
+    {
+        if (std::ranges::find(params, name, &ast::Identifier::value) !=
+            params.end()) {
+            return std::nullopt;
+        } else if (arch) {
+            return find_constant(name, *arch);
+        } else if (depends_on_arch(name)) {
+            return std::nullopt;
+        }
+        return find_constant(name);
+    }
+
+    static const ast::IntLit* literal(const ast::IntExpr& e)
+    {
+        return std::get_if<ast::IntLit>(&e);
+    }
+
+    ast::IntExpr* fold(ast::IntExpr* e) const
+    {
+        return std::visit(hana::overload(
+            [&](const ast::IntLit&) { return e; },
+            [&](const ast::Identifier& id) {
+                if (auto value = constant(id.value) ; value) {
+                    return ast::make_int_expr<ast::IntLit>(
+                        id.line, id.column, static_cast<std::int64_t>(*value));
+                }
+                return e;
+            },
+            [&]<class T>(const T& binary) {
+                auto left = fold(binary.left);
+                auto right = fold(binary.right);
+                bool foldable = literal(*left) && literal(*right);
+                if constexpr (std::is_same_v<T, ast::DivExpr>) {
+                    // kept for lowering to report
+                    if (foldable && literal(*right)->value == 0) {
+                        foldable = false;
+                    }
+                }
+                if (foldable) {
+                    // only the value is kept, so the node stays on the stack
+                    ast::IntExpr folded{
+                        std::in_place_type<T>, binary.line, binary.column,
+                        left, right};
+                    return ast::make_int_expr<ast::IntLit>(
+                        binary.line, binary.column,
+                        static_cast<std::int64_t>(eval(folded)));
+                }
+                if (left == binary.left && right == binary.right) {
+                    return e;
+                }
+                return ast::make_int_expr<T>(
+                    binary.line, binary.column, left, right);
+            }
+        ), *e);
+    }
+
+    ast::BoolExpr* fold(ast::BoolExpr* e) const
+    {
+        return std::visit(hana::overload(
+            [&](const ast::NegExpr& neg) {
+                auto inner = fold(neg.inner);
+                if (inner == neg.inner) {
+                    return e;
+                }
+                return ast::make_bool_expr<ast::NegExpr>(
+                    neg.line, neg.column, inner);
+            },
+            [&]<class T>(const T& binary) {
+                auto left = fold(binary.left);
+                auto right = fold(binary.right);
+                if (left == binary.left && right == binary.right) {
+                    return e;
+                }
+                return ast::make_bool_expr<T>(
+                    binary.line, binary.column, left, right);
+            }
+        ), *e);
+    }
+};
+
+void fold(ast::ActionBlock& block)
+{
+    for (auto& filter : block.filters) {
+        fold_constants(filter);
+    }
+}
+
+} // namespace
+
+std::span<const Constant> constants()
+{
+    return table;
+}
+
+std::optional<std::uint64_t> find_constant(std::string_view name)
+{
+    return find(table, name);
+}
+
+std::optional<std::uint64_t> find_constant(
+    std::string_view name, const Arch& arch)
+{
+    auto t = std::ranges::find(arch_tables, arch.token, &ArchConstants::token);
+    if (t != arch_tables.end()) {
+        if (auto value = find(t->values, name) ; value) {
+            return value;
+        }
+    }
+    return find(table, name);
+}
+
+bool depends_on_arch(std::string_view name)
+{
+    return std::ranges::any_of(arch_tables, [&](const ArchConstants& t) {
+        return find(t.values, name).has_value();
+    });
+}
+
+std::optional<std::uint32_t> find_errno(std::string_view name)
+{
+    return find(errnos, name);
+}
+
+void fold_constants(ast::SyscallFilter& filter, const Arch* arch)
+{
+    std::optional<ast::ArenaScope> arena;
+    if (!ast::current_arena()) {
+        arena.emplace();
+    }
+
+    Folder folder{filter.params, arch};
+    for (auto& expr : filter.body) {
+        expr = ast::share(folder.fold(expr.get()), expr);
+    }
+}
+
+void fold_constants(std::vector<ast::ProgramStatement>& ast)
+{
+    for (auto& stmt : ast) {
+        std::visit(hana::overload(
+            [](ast::Policy& policy) {
+                for (auto& stmt : policy.body) {
+                    if (auto block = std::get_if<ast::ActionBlock>(&stmt)) {
+                        fold(*block);
+                    }
+                }
+            },
+            [](ast::ActionBlock& block) { fold(block); },
+            [](auto&) {}
+        ), stmt);
+    }
+}
+
+} // namespace fekal
@@ -0,0 +1,150 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/exprtable.hpp>
+#include <boost/container_hash/hash.hpp>
+#include <boost/hana/functional/overload.hpp>
+
+namespace fekal {
+
+namespace hana = boost::hana;
+
+ExprTable::ExprTable()
+    : arena_{std::make_shared<ast::Arena>()}
+{}
+
+std::shared_ptr<ast::BoolExpr> ExprTable::intern(
+    const std::shared_ptr<ast::BoolExpr>& expr)
+{
+    // the table holds on to nodes of `expr`, even when returning it as is
+    arena_->retain(expr);
+    ast::ArenaScope scope{arena_};
+    return ast::share(intern(expr.get()), expr);
+}
+
+ast::IntExpr* ExprTable::intern(ast::IntExpr* expr)
+{
+    auto node = std::visit(hana::overload(
+        [&](const ast::IntLit&) { return expr; },
+        [&](const ast::Identifier&) { return expr; },
+        [&]<class T>(const T& e) {
+            auto left = intern(e.left);
+            auto right = intern(e.right);
+            if (left == e.left && right == e.right) {
+                return expr;
+            }
+            return ast::make_int_expr<T>(e.line, e.column, left, right);
+        }
+    ), *expr);
+    return *ints.insert(node).first;
+}
+
+ast::BoolExpr* ExprTable::intern(ast::BoolExpr* expr)
+{
+    auto node = std::visit(hana::overload(
+        [&](const ast::NegExpr& e) {
+            auto inner = intern(e.inner);
+            if (inner == e.inner) {
+                return expr;
+            }
+            return ast::make_bool_expr<ast::NegExpr>(e.line, e.column, inner);
+        },
+        [&]<class T>(const T& e) {
+            auto left = intern(e.left);
+            auto right = intern(e.right);
+            if (left == e.left && right == e.right) {
+                return expr;
+            }
+            return ast::make_bool_expr<T>(e.line, e.column, left, right);
+        }
+    ), *expr);
+    return *bools.insert(node).first;
+}
+
+void ExprTable::intern(std::vector<ast::ProgramStatement>& ast)
+{
+    auto block = [&](ast::ActionBlock& block) {
+        for (auto& filter : block.filters) {
+            for (auto& expr : filter.body) {
+                expr = intern(expr);
+            }
+        }
+    };
+
+    for (auto& stmt : ast) {
+        std::visit(hana::overload(
+            [&](ast::Policy& policy) {
+                for (auto& stmt : policy.body) {
+                    if (auto b = std::get_if<ast::ActionBlock>(&stmt) ; b) {
+                        block(*b);
+                    }
+                }
+            },
+            [&](ast::ActionBlock& b) { block(b); },
+            [](auto&) {}
+        ), stmt);
+    }
+}
+
+std::size_t ExprTable::Hash::operator()(const ast::IntExpr* e) const
+{
+    std::size_t seed = e->index();
+    std::visit(hana::overload(
+        [&](const ast::IntLit& e) { boost::hash_combine(seed, e.value); },
+        [&](const ast::Identifier& e) { boost::hash_combine(seed, e.symbol); },
+        [&](const auto& e) {
+            boost::hash_combine(seed, e.left);
+            boost::hash_combine(seed, e.right);
+        }
+    ), *e);
+    return seed;
+}
+
+std::size_t ExprTable::Hash::operator()(const ast::BoolExpr* e) const
+{
+    std::size_t seed = e->index();
+    std::visit(hana::overload(
+        [&](const ast::NegExpr& e) { boost::hash_combine(seed, e.inner); },
+        [&](const auto& e) {
+            boost::hash_combine(seed, e.left);
+            boost::hash_combine(seed, e.right);
+        }
+    ), *e);
+    return seed;
+}
+
+bool ExprTable::Equal::operator()(
+    const ast::IntExpr* a, const ast::IntExpr* b) const
+{
+    if (a->index() != b->index()) {
+        return false;
+    }
+    return std::visit(hana::overload(
+        [&](const ast::IntLit& e) {
+            return e.value == std::get<ast::IntLit>(*b).value; },
+        [&](const ast::Identifier& e) {
+            return e.symbol == std::get<ast::Identifier>(*b).symbol; },
+        [&]<class T>(const T& e) {
+            const auto& o = std::get<T>(*b);
+            return e.left == o.left && e.right == o.right;
+        }
+    ), *a);
+}
+
+bool ExprTable::Equal::operator()(
+    const ast::BoolExpr* a, const ast::BoolExpr* b) const
+{
+    if (a->index() != b->index()) {
+        return false;
+    }
+    return std::visit(hana::overload(
+        [&](const ast::NegExpr& e) {
+            return e.inner == std::get<ast::NegExpr>(*b).inner; },
+        [&]<class T>(const T& e) {
+            const auto& o = std::get<T>(*b);
+            return e.left == o.left && e.right == o.right;
+        }
+    ), *a);
+}
+
+} // namespace fekal
@@ -0,0 +1,37 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/ir.hpp>
+#include <boost/hana/functional/overload.hpp>
+
+namespace fekal::ir {
+
+namespace hana = boost::hana;
+
+std::uint32_t action_value(const ast::Action& action)
+{
+    return std::visit(hana::overload(
+        [](const ast::ActionAllow&) { return SECCOMP_RET_ALLOW; },
+        [](const ast::ActionLog&) { return SECCOMP_RET_LOG; },
+        [](const ast::ActionKillProcess&) { return SECCOMP_RET_KILL_PROCESS; },
+        [](const ast::ActionKillThread&) { return SECCOMP_RET_KILL_THREAD; },
+        [](const ast::ActionUserNotif&) { return SECCOMP_RET_USER_NOTIF; },
+        [](const ast::ActionErrno& a) {
+            return SECCOMP_RET_ERRNO | (a.errnum & SECCOMP_RET_DATA); },
+        [](const ast::ActionTrap& a) {
+            return SECCOMP_RET_TRAP |
+                (static_cast<std::uint32_t>(a.code) & SECCOMP_RET_DATA); },
+        [](const ast::ActionTrace& a) {
+            return SECCOMP_RET_TRACE |
+                (static_cast<std::uint32_t>(a.code) & SECCOMP_RET_DATA); }
+    ), action);
+}
+
+std::int64_t precedence(std::uint32_t action)
+{
+    // the kernel picks the lowest action as a signed value
+    return -static_cast<std::int64_t>(
+        static_cast<std::int32_t>(action & SECCOMP_RET_ACTION_FULL));
+}
+
+} // namespace fekal::ir
@@ -2,10 +2,18 @@
 // SPDX-License-Identifier: MIT-0
 
 #include <fekal/parser.hpp>
-#include <fekal/reader.hpp>
+#include <fekal/token_array.hpp>
 #include <fekal/peg.hpp>
+#include <fekal/constants.hpp>
+#include <fekal/symbols.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <iterator>
 #include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
 #include <boost/hana/functional/overload.hpp>
 
@@ -18,57 +26,101 @@ using peg::choice;
 
 struct recursion_context_rules;
 using recursion_context =
-    peg::basic_recursion_context<reader, recursion_context_rules>;
-using IntExprPtr = std::shared_ptr<ast::IntExpr>;
-using BoolExprPtr = std::shared_ptr<ast::BoolExpr>;
+    peg::basic_recursion_context<token_cursor, recursion_context_rules>;
+using IntExprPtr = ast::IntExpr*;
+using BoolExprPtr = ast::BoolExpr*;
 
 static
 mp11::mp_push_front<ast::ProgramStatement, std::monostate>
-ProgramStatement(const recursion_context& recur, reader& r);
+ProgramStatement(const recursion_context& recur, token_cursor& r);
 
 static
-std::optional<ast::Policy> Policy(const recursion_context& recur, reader& r);
+std::optional<ast::Policy> Policy(const recursion_context& recur, token_cursor& r);
 
 static
 mp11::mp_push_front<ast::PolicyStatement, std::monostate>
-PolicyStatement(const recursion_context& recur, reader& r);
+PolicyStatement(const recursion_context& recur, token_cursor& r);
 
 static
 std::optional<ast::UseStatement>
-UseStatement(const recursion_context& recur, reader& r);
+UseStatement(const recursion_context& recur, token_cursor& r);
 
 static
 std::optional<ast::ActionBlock>
-ActionBlock(const recursion_context& recur, reader& r);
+ActionBlock(const recursion_context& recur, token_cursor& r);
 
 static
 mp11::mp_push_front<ast::Action, std::monostate>
-Action(const recursion_context& recur, reader& r);
+Action(const recursion_context& recur, token_cursor& r);
 
 static
 std::optional<ast::SyscallFilter>
-SyscallFilter(const recursion_context& recur, reader& r);
-
-static BoolExprPtr OrExpr(const recursion_context& recur, reader& r);
-static BoolExprPtr AndExpr(const recursion_context& recur, reader& r);
-static BoolExprPtr RelOpExpr(const recursion_context& recur, reader& r);
-static IntExprPtr BitOrExpr(const recursion_context& recur, reader& r);
-static IntExprPtr BitXorExpr(const recursion_context& recur, reader& r);
-static IntExprPtr BitAndExpr(const recursion_context& recur, reader& r);
-static IntExprPtr BitShiftExpr(const recursion_context& recur, reader& r);
-static IntExprPtr SumExpr(const recursion_context& recur, reader& r);
-static IntExprPtr MulExpr(const recursion_context& recur, reader& r);
-static IntExprPtr Term(const recursion_context& recur, reader& r);
+SyscallFilter(const recursion_context& recur, token_cursor& r);
+
+static BoolExprPtr OrExpr(const recursion_context& recur, token_cursor& r);
+static BoolExprPtr AndExpr(const recursion_context& recur, token_cursor& r);
+static BoolExprPtr RelOpExpr(const recursion_context& recur, token_cursor& r);
+static IntExprPtr BitOrExpr(const recursion_context& recur, token_cursor& r);
+static IntExprPtr BitXorExpr(const recursion_context& recur, token_cursor& r);
+static IntExprPtr BitAndExpr(const recursion_context& recur, token_cursor& r);
+static IntExprPtr BitShiftExpr(const recursion_context& recur, token_cursor& r);
+static IntExprPtr SumExpr(const recursion_context& recur, token_cursor& r);
+static IntExprPtr MulExpr(const recursion_context& recur, token_cursor& r);
+static IntExprPtr Term(const recursion_context& recur, token_cursor& r);
+
+namespace climbing {
+static BoolExprPtr or_expr(token_cursor& r);
+} // namespace climbing
+
+// FIRST sets, so rules and alternatives that can't start with the current
+// token aren't tried
+struct first_sets
+{
+    using enum token::symbol;
+
+    using integer = peg::first<LIT_BIN, LIT_OCT, LIT_DEC, LIT_HEX>;
+    using term = peg::first_union<integer, peg::first<IDENTIFIER, LPAREN>>;
+    using bool_expr = peg::first_union<term, peg::first<OP_NEG>>;
+    using action = peg::first<
+        KW_ALLOW, KW_LOG, KW_KILL_PROCESS, KW_KILL_THREAD, KW_USER_NOTIF,
+        KW_ERRNO, KW_TRAP, KW_TRACE>;
+    using policy_statement = peg::first_union<peg::first<KW_USE>, action>;
+    using program_statement = peg::first_union<
+        policy_statement, peg::first<KW_POLICY, KW_DEFAULT>>;
+};
+
+template<> struct peg::rule_first<ProgramStatement>
+    : first_sets::program_statement {};
+template<> struct peg::rule_first<Policy>
+    : peg::first<token::symbol::KW_POLICY> {};
+template<> struct peg::rule_first<PolicyStatement>
+    : first_sets::policy_statement {};
+template<> struct peg::rule_first<UseStatement>
+    : peg::first<token::symbol::KW_USE> {};
+template<> struct peg::rule_first<ActionBlock> : first_sets::action {};
+template<> struct peg::rule_first<Action> : first_sets::action {};
+template<> struct peg::rule_first<SyscallFilter>
+    : peg::first<token::symbol::IDENTIFIER> {};
+template<> struct peg::rule_first<OrExpr> : first_sets::bool_expr {};
+template<> struct peg::rule_first<AndExpr> : first_sets::bool_expr {};
+template<> struct peg::rule_first<RelOpExpr> : first_sets::bool_expr {};
+template<> struct peg::rule_first<BitOrExpr> : first_sets::term {};
+template<> struct peg::rule_first<BitXorExpr> : first_sets::term {};
+template<> struct peg::rule_first<BitAndExpr> : first_sets::term {};
+template<> struct peg::rule_first<BitShiftExpr> : first_sets::term {};
+template<> struct peg::rule_first<SumExpr> : first_sets::term {};
+template<> struct peg::rule_first<MulExpr> : first_sets::term {};
+template<> struct peg::rule_first<Term> : first_sets::term {};
 
 struct recursion_context_rules
     : peg::basic_recursion_context_rules<
-        reader, recursion_context_rules,
+        token_cursor, recursion_context_rules,
         OrExpr, AndExpr, RelOpExpr, BitOrExpr, BitXorExpr, BitAndExpr,
         BitShiftExpr, SumExpr, MulExpr, Term>
 {};
 
 template<token::symbol S>
-static inline bool expect(reader& r)
+static inline bool expect(token_cursor& r)
 {
     if (S == token::symbol::END) {
         return r.symbol() == token::symbol::END;
@@ -82,7 +134,7 @@ static inline bool expect(reader& r)
     }
 }
 
-static inline std::optional<std::int64_t> INTEGER(reader& r)
+static inline std::optional<std::int64_t> INTEGER(token_cursor& r)
 {
     std::int64_t ret;
     if (r.symbol() == token::symbol::LIT_BIN) {
@@ -100,9 +152,23 @@ static inline std::optional<std::int64_t> INTEGER(reader& r)
     return ret;
 }
 
+// Versions are labels. Numeric ones are kept in decimal, so `0x10` and `16`
+// name the same version.
+static inline std::optional<std::string_view> VERSION(token_cursor& r)
+{
+    auto spelled = r.literal();
+    if (auto value = INTEGER(r) ; value) {
+        return spelling(intern(std::to_string(*value)));
+    } else if (r.symbol() == token::symbol::IDENTIFIER) {
+        r.next();
+        return spelled;
+    }
+    return std::nullopt;
+}
+
 static
 mp11::mp_push_front<ast::ProgramStatement, std::monostate>
-ProgramStatement(const recursion_context& recur, reader& r)
+ProgramStatement(const recursion_context& recur, token_cursor& r)
 {
     using Ret = mp11::mp_push_front<ast::ProgramStatement, std::monostate>;
     if (auto res = recur.enter<Policy>(r) ; res) {
@@ -125,7 +191,7 @@ ProgramStatement(const recursion_context& recur, reader& r)
 }
 
 static
-std::optional<ast::Policy> Policy(const recursion_context& recur, reader& r)
+std::optional<ast::Policy> Policy(const recursion_context& recur, token_cursor& r)
 {
     auto backup = r;
     if (
@@ -136,18 +202,13 @@ std::optional<ast::Policy> Policy(const recursion_context& recur, reader& r)
         return std::nullopt;
     }
 
-    std::string name = r.value<token::symbol::IDENTIFIER>();
+    auto name = r.value<token::symbol::IDENTIFIER>();
     r.next();
     auto line = r.line();
     auto column = r.column();
 
-    std::string version;
-    if (auto res = INTEGER(r) ; res) {
-        version = std::to_string(*res);
-    } else if (r.symbol() == token::symbol::IDENTIFIER) {
-        version = r.value<token::symbol::IDENTIFIER>();
-        r.next();
-    } else {
+    auto version = VERSION(r);
+    if (!version) {
         r = backup;
         return std::nullopt;
     }
@@ -168,7 +229,7 @@ std::optional<ast::Policy> Policy(const recursion_context& recur, reader& r)
             continue;
         } else {
             if (expect<token::symbol::RBRACE>(r)) {
-                return ast::Policy{line, column, std::move(name), std::move(version), std::move(stmts)};
+                return ast::Policy{line, column, std::move(name), *version, std::move(stmts)};
             } else {
                 r = backup;
                 return std::nullopt;
@@ -179,7 +240,7 @@ std::optional<ast::Policy> Policy(const recursion_context& recur, reader& r)
 
 static
 mp11::mp_push_front<ast::PolicyStatement, std::monostate>
-PolicyStatement(const recursion_context& recur, reader& r)
+PolicyStatement(const recursion_context& recur, token_cursor& r)
 {
     if (auto res = recur.enter<UseStatement>(r) ; res) {
         return *res;
@@ -192,7 +253,7 @@ PolicyStatement(const recursion_context& recur, reader& r)
 
 static
 std::optional<ast::UseStatement>
-UseStatement(const recursion_context& recur, reader& r)
+UseStatement(const recursion_context& recur, token_cursor& r)
 {
     auto backup = r;
     if (
@@ -203,28 +264,23 @@ UseStatement(const recursion_context& recur, reader& r)
         return std::nullopt;
     }
 
-    std::string policy = r.value<token::symbol::IDENTIFIER>();
+    auto policy = r.value<token::symbol::IDENTIFIER>();
     r.next();
     auto line = r.line();
     auto column = r.column();
 
-    std::string version;
-    if (auto res = INTEGER(r); res) {
-        version = std::to_string(*res);
-    } else if (r.symbol() == token::symbol::IDENTIFIER) {
-        version = r.value<token::symbol::IDENTIFIER>();
-        r.next();
-    } else {
+    auto version = VERSION(r);
+    if (!version) {
         r = backup;
         return std::nullopt;
     }
 
-    return ast::UseStatement{line, column, policy, version};
+    return ast::UseStatement{line, column, policy, *version};
 }
 
 static
 std::optional<ast::ActionBlock>
-ActionBlock(const recursion_context& recur, reader& r)
+ActionBlock(const recursion_context& recur, token_cursor& r)
 {
     auto backup = r;
     std::optional<ast::Action> action;
@@ -270,7 +326,7 @@ ActionBlock(const recursion_context& recur, reader& r)
 
 static
 mp11::mp_push_front<ast::Action, std::monostate>
-Action(const recursion_context& recur, reader& r)
+Action(const recursion_context& recur, token_cursor& r)
 {
     auto backup = r;
     switch (r.symbol()) {
@@ -303,8 +359,15 @@ Action(const recursion_context& recur, reader& r)
                 return {};
             }
             return ast::ActionErrno{static_cast<int>(*res)};
+        } else if (r.symbol() == token::symbol::IDENTIFIER) {
+            auto errnum = find_errno(r.value<token::symbol::IDENTIFIER>());
+            r.next();
+            if (!errnum || !expect<token::symbol::RPAREN>(r)) {
+                r = backup;
+                return {};
+            }
+            return ast::ActionErrno{static_cast<int>(*errnum)};
         } else {
-            // TODO: handle known errno constants
             r = backup;
             return {};
         }
@@ -346,13 +409,13 @@ Action(const recursion_context& recur, reader& r)
 
 static
 std::optional<ast::SyscallFilter>
-SyscallFilter(const recursion_context& recur, reader& r)
+SyscallFilter(const recursion_context& recur, token_cursor& r)
 {
     if (r.symbol() != token::symbol::IDENTIFIER) {
         return std::nullopt;
     }
 
-    std::string syscall = r.value<token::symbol::IDENTIFIER>();
+    auto syscall = r.value<token::symbol::IDENTIFIER>();
     r.next();
 
     auto line = r.line();
@@ -360,7 +423,7 @@ SyscallFilter(const recursion_context& recur, reader& r)
 
     auto return_matched = [&r,&syscall,backup=r, &line, &column]() {
         r = backup;
-        return ast::SyscallFilter{line, column, std::move(syscall)};
+        return ast::SyscallFilter{line, column, syscall};
     };
 
     if (!expect<token::symbol::LPAREN>(r)) {
@@ -396,11 +459,15 @@ SyscallFilter(const recursion_context& recur, reader& r)
         return return_matched();
     }
 
-    std::vector<BoolExprPtr> body;
+    std::vector<std::shared_ptr<ast::BoolExpr>> body;
     for (;;) {
+#if defined(FEKAL_PRECEDENCE_CLIMBING)
+        auto expr = climbing::or_expr(r);
+#else // defined(FEKAL_PRECEDENCE_CLIMBING)
         auto expr = recur.enter<OrExpr>(r);
+#endif // defined(FEKAL_PRECEDENCE_CLIMBING)
         if (expr) {
-            body.emplace_back(std::move(expr));
+            body.push_back(ast::share(expr));
             switch (r.symbol()) {
             default:
                 return return_matched();
@@ -412,7 +479,7 @@ SyscallFilter(const recursion_context& recur, reader& r)
                 return ast::SyscallFilter{
                     line,
                     column,
-                    std::move(syscall),
+                    syscall,
                     std::move(params),
                     std::move(body),
                 };
@@ -422,7 +489,7 @@ SyscallFilter(const recursion_context& recur, reader& r)
                 return ast::SyscallFilter{
                     line,
                     column,
-                    std::move(syscall),
+                    syscall,
                     std::move(params),
                     std::move(body),
                 };
@@ -433,12 +500,12 @@ SyscallFilter(const recursion_context& recur, reader& r)
     }
 }
 
-static BoolExprPtr OrExpr(const recursion_context& recur, reader& r)
+static BoolExprPtr OrExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // OrExpr '||' AndExpr
-        [](const recursion_context& recur, reader& r) -> BoolExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> BoolExprPtr {
             auto e1 = recur.enter<OrExpr>(r);
             if (!e1) {
                 return nullptr;
@@ -458,17 +525,17 @@ static BoolExprPtr OrExpr(const recursion_context& recur, reader& r)
                 l, c, std::move(e1), std::move(e2));
         },
         // AndExpr
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<AndExpr>(r);
         });
 }
 
-static BoolExprPtr AndExpr(const recursion_context& recur, reader& r)
+static BoolExprPtr AndExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // AndExpr "&&" RelOpExpr
-        [](const recursion_context& recur, reader& r) -> BoolExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> BoolExprPtr {
             auto e1 = recur.enter<AndExpr>(r);
             if (!e1) {
                 return nullptr;
@@ -488,17 +555,18 @@ static BoolExprPtr AndExpr(const recursion_context& recur, reader& r)
                 l, c, std::move(e1), std::move(e2));
         },
         // RelOpExpr
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<RelOpExpr>(r);
         });
 }
 
-static BoolExprPtr RelOpExpr(const recursion_context& recur, reader& r)
+static BoolExprPtr RelOpExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // BitOrExpr ("==" / "!=" / "<" / ">" / "<=" / ">=") BitOrExpr
-        [](const recursion_context& recur, reader& r) -> BoolExprPtr {
+        peg::guard<first_sets::term>(
+        [](const recursion_context& recur, token_cursor& r) -> BoolExprPtr {
             static constexpr auto OP_EQ = token::symbol::OP_EQ;
             static constexpr auto OP_NE = token::symbol::OP_NE;
             static constexpr auto OP_LT = token::symbol::OP_LT;
@@ -553,9 +621,10 @@ static BoolExprPtr RelOpExpr(const recursion_context& recur, reader& r)
             default:
                 assert(false);
             }
-        },
+        }),
         // '!'? '(' OrExpr ')'
-        [](const recursion_context& recur, reader& r) -> BoolExprPtr {
+        peg::guard<peg::first<token::symbol::OP_NEG, token::symbol::LPAREN>>(
+        [](const recursion_context& recur, token_cursor& r) -> BoolExprPtr {
             bool is_neg = r.symbol() == token::symbol::OP_NEG;
             auto l = r.line();
             auto c = r.column();
@@ -577,15 +646,15 @@ static BoolExprPtr RelOpExpr(const recursion_context& recur, reader& r)
             } else {
                 return e;
             }
-        });
+        }));
 }
 
-static IntExprPtr BitOrExpr(const recursion_context& recur, reader& r)
+static IntExprPtr BitOrExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // BitOrExpr '|' BitXorExpr
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             auto bo = recur.enter<BitOrExpr>(r);
             if (!bo) {
                 return nullptr;
@@ -605,17 +674,17 @@ static IntExprPtr BitOrExpr(const recursion_context& recur, reader& r)
                 l, c, std::move(bo), std::move(bx));
         },
         // BitXorExpr
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<BitXorExpr>(r);
         });
 }
 
-static IntExprPtr BitXorExpr(const recursion_context& recur, reader& r)
+static IntExprPtr BitXorExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // BitXorExpr '^' BitAndExpr
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             auto bx = recur.enter<BitXorExpr>(r);
             if (!bx) {
                 return nullptr;
@@ -635,17 +704,17 @@ static IntExprPtr BitXorExpr(const recursion_context& recur, reader& r)
                 l, c, std::move(bx), std::move(ba));
         },
         // BitAndExpr
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<BitAndExpr>(r);
         });
 }
 
-static IntExprPtr BitAndExpr(const recursion_context& recur, reader& r)
+static IntExprPtr BitAndExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // BitAndExpr '&' BitShiftExpr
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             auto ba = recur.enter<BitAndExpr>(r);
             if (!ba) {
                 return nullptr;
@@ -665,17 +734,17 @@ static IntExprPtr BitAndExpr(const recursion_context& recur, reader& r)
                 l, c, std::move(ba), std::move(bs));
         },
         // BitShiftExpr
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<BitShiftExpr>(r);
         });
 }
 
-static IntExprPtr BitShiftExpr(const recursion_context& recur, reader& r)
+static IntExprPtr BitShiftExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // BitShiftExpr ("<<" / ">>") SumExpr
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             static constexpr auto OP_LSHIFT = token::symbol::OP_LSHIFT;
             static constexpr auto OP_RSHIFT = token::symbol::OP_RSHIFT;
 
@@ -704,17 +773,17 @@ static IntExprPtr BitShiftExpr(const recursion_context& recur, reader& r)
             }
         },
         // SumExpr
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<SumExpr>(r);
         });
 }
 
-static IntExprPtr SumExpr(const recursion_context& recur, reader& r)
+static IntExprPtr SumExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // SumExpr ('+' / '-') MulExpr
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             static constexpr auto OP_PLUS = token::symbol::OP_PLUS;
             static constexpr auto OP_MINUS = token::symbol::OP_MINUS;
 
@@ -743,17 +812,17 @@ static IntExprPtr SumExpr(const recursion_context& recur, reader& r)
             }
         },
         // MulExpr
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<MulExpr>(r);
         });
 }
 
-static IntExprPtr MulExpr(const recursion_context& recur, reader& r)
+static IntExprPtr MulExpr(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // MulExpr ('*' / '/') Term
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             static constexpr auto OP_MUL = token::symbol::OP_MUL;
             static constexpr auto OP_DIV = token::symbol::OP_DIV;
 
@@ -782,17 +851,18 @@ static IntExprPtr MulExpr(const recursion_context& recur, reader& r)
             }
         },
         // Term
-        [](const recursion_context& recur, reader& r) {
+        [](const recursion_context& recur, token_cursor& r) {
             return recur.enter<Term>(r);
         });
 }
 
-static IntExprPtr Term(const recursion_context& recur, reader& r)
+static IntExprPtr Term(const recursion_context& recur, token_cursor& r)
 {
     return choice(
         recur, r,
         // INTEGER
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        peg::guard<first_sets::integer>(
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             auto l = r.line();
             auto c = r.column();
             if (auto res = INTEGER(r) ; res) {
@@ -800,9 +870,10 @@ static IntExprPtr Term(const recursion_context& recur, reader& r)
             } else {
                 return nullptr;
             }
-        },
+        }),
         // IDENTIFIER
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        peg::guard<peg::first<token::symbol::IDENTIFIER>>(
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             if (r.symbol() == token::symbol::IDENTIFIER) {
                 auto ret = ast::make_int_expr<ast::Identifier>(
                     r.line(), r.column(), r.value<token::symbol::IDENTIFIER>());
@@ -811,9 +882,10 @@ static IntExprPtr Term(const recursion_context& recur, reader& r)
             } else {
                 return nullptr;
             }
-        },
+        }),
         // '(' BitOrExpr ')'
-        [](const recursion_context& recur, reader& r) -> IntExprPtr {
+        peg::guard<peg::first<token::symbol::LPAREN>>(
+        [](const recursion_context& recur, token_cursor& r) -> IntExprPtr {
             if (!expect<token::symbol::LPAREN>(r)) {
                 return nullptr;
             }
@@ -824,29 +896,477 @@ static IntExprPtr Term(const recursion_context& recur, reader& r)
             }
 
             return e;
-        });
+        }));
+}
+
+// Precedence climbing over the same grammar as OrExpr ... Term. Every operand
+// is parsed once, so a chain of n operators takes O(n) steps where the
+// left-recursion bound re-parses the chain once per extra operand. Trees,
+// positions and the token where a partial match stops are the same as with
+// the PEG rules:
+//
+// - Binary operators associate to the left.
+// - Comparisons take two BitOrExpr and don't chain.
+// - If the operand after an operator doesn't parse, the expression ends
+//   before the operator. An enclosing level retrying that operator would fail
+//   the same way, so `stuck` stops every level there.
+// - A comparison is tried before a parenthesised OrExpr, so in
+//   `((fd == 1))` every '(' is first read as the start of a Term. What a
+//   parenthesised Term parses to depends only on where it starts, so it's
+//   remembered (see `parens`) rather than parsed again from each enclosing
+//   level, which would take time quadratic in the depth.
+namespace climbing {
+
+// Parenthesised Terms already parsed, keyed by the ordinal of their '('.
+// Failures are kept as nullptr.
+using parens =
+    std::unordered_map<unsigned, std::pair<IntExprPtr, token_cursor>>;
+
+// 0 for tokens that aren't binary integer operators
+static unsigned int_precedence(token::symbol s)
+{
+    switch (s) {
+    case token::symbol::OP_BOR:
+        return 1;
+    case token::symbol::OP_BXOR:
+        return 2;
+    case token::symbol::OP_BAND:
+        return 3;
+    case token::symbol::OP_LSHIFT:
+    case token::symbol::OP_RSHIFT:
+        return 4;
+    case token::symbol::OP_PLUS:
+    case token::symbol::OP_MINUS:
+        return 5;
+    case token::symbol::OP_MUL:
+    case token::symbol::OP_DIV:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static IntExprPtr make_int_expr(
+    token::symbol op, unsigned l, unsigned c, IntExprPtr e1, IntExprPtr e2)
+{
+    switch (op) {
+    case token::symbol::OP_BOR:
+        return ast::make_int_expr<ast::BitOrExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_BXOR:
+        return ast::make_int_expr<ast::BitXorExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_BAND:
+        return ast::make_int_expr<ast::BitAndExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_LSHIFT:
+        return ast::make_int_expr<ast::LshiftExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_RSHIFT:
+        return ast::make_int_expr<ast::RshiftExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_PLUS:
+        return ast::make_int_expr<ast::SumExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_MINUS:
+        return ast::make_int_expr<ast::SubtractExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_MUL:
+        return ast::make_int_expr<ast::MulExpr>(
+            l, c, std::move(e1), std::move(e2));
+    case token::symbol::OP_DIV:
+        return ast::make_int_expr<ast::DivExpr>(
+            l, c, std::move(e1), std::move(e2));
+    default:
+        assert(false);
+        return nullptr;
+    }
+}
+
+static IntExprPtr int_expr(
+    parens& memo, token_cursor& r, unsigned min_prec, bool& stuck);
+
+// INTEGER / IDENTIFIER / '(' BitOrExpr ')'
+static IntExprPtr term(parens& memo, token_cursor& r)
+{
+    auto l = r.line();
+    auto c = r.column();
+    if (auto res = INTEGER(r) ; res) {
+        return ast::make_int_expr<ast::IntLit>(l, c, *res);
+    }
+
+    if (r.symbol() == token::symbol::IDENTIFIER) {
+        auto ret = ast::make_int_expr<ast::Identifier>(
+            l, c, r.value<token::symbol::IDENTIFIER>());
+        r.next();
+        return ret;
+    }
+
+    if (r.symbol() != token::symbol::LPAREN) {
+        return nullptr;
+    }
+
+    if (auto it = memo.find(r.ordinal()) ; it != memo.end()) {
+        if (it->second.first) {
+            r = it->second.second;
+        }
+        return it->second.first;
+    }
+
+    auto backup = r;
+    r.next();
+    bool stuck = false;
+    auto e = int_expr(memo, r, 1, stuck);
+    if (!e || !expect<token::symbol::RPAREN>(r)) {
+        e = nullptr;
+    }
+    memo.emplace(backup.ordinal(), std::pair{e, r});
+    if (!e) {
+        r = backup;
+    }
+    return e;
+}
+
+static IntExprPtr int_expr(
+    parens& memo, token_cursor& r, unsigned min_prec, bool& stuck)
+{
+    auto e1 = term(memo, r);
+    if (!e1) {
+        return nullptr;
+    }
+
+    while (!stuck) {
+        auto op = r.symbol();
+        auto prec = int_precedence(op);
+        if (prec == 0 || prec < min_prec) {
+            break;
+        }
+
+        auto backup = r;
+        auto l = r.line();
+        auto c = r.column();
+        r.next();
+        auto e2 = int_expr(memo, r, prec + 1, stuck);
+        if (!e2) {
+            r = backup;
+            stuck = true;
+            break;
+        }
+        e1 = make_int_expr(op, l, c, std::move(e1), std::move(e2));
+    }
+    return e1;
+}
+
+static BoolExprPtr bool_expr(
+    parens& memo, token_cursor& r, unsigned min_prec, bool& stuck);
+
+// BitOrExpr ("==" / "!=" / "<" / ">" / "<=" / ">=") BitOrExpr /
+// '!'? '(' OrExpr ')'
+static BoolExprPtr relop_expr(parens& memo, token_cursor& r)
+{
+    auto backup = r;
+
+    bool stuck = false;
+    if (auto b1 = int_expr(memo, r, 1, stuck) ; b1) {
+        auto op = r.symbol();
+        auto l = r.line();
+        auto c = r.column();
+        switch (op) {
+        default:
+            break;
+        case token::symbol::OP_EQ:
+        case token::symbol::OP_NE:
+        case token::symbol::OP_LT:
+        case token::symbol::OP_GT:
+        case token::symbol::OP_LTE:
+        case token::symbol::OP_GTE:
+            r.next();
+            stuck = false;
+            auto b2 = int_expr(memo, r, 1, stuck);
+            if (!b2) {
+                break;
+            }
+            switch (op) {
+            case token::symbol::OP_EQ:
+                return ast::make_bool_expr<ast::EqExpr>(
+                    l, c, std::move(b1), std::move(b2));
+            case token::symbol::OP_NE:
+                return ast::make_bool_expr<ast::NeqExpr>(
+                    l, c, std::move(b1), std::move(b2));
+            case token::symbol::OP_LT:
+                return ast::make_bool_expr<ast::LtExpr>(
+                    l, c, std::move(b1), std::move(b2));
+            case token::symbol::OP_GT:
+                return ast::make_bool_expr<ast::GtExpr>(
+                    l, c, std::move(b1), std::move(b2));
+            case token::symbol::OP_LTE:
+                return ast::make_bool_expr<ast::LteExpr>(
+                    l, c, std::move(b1), std::move(b2));
+            default: assert(op == token::symbol::OP_GTE);
+                return ast::make_bool_expr<ast::GteExpr>(
+                    l, c, std::move(b1), std::move(b2));
+            }
+        }
+        r = backup;
+    }
+
+    bool is_neg = r.symbol() == token::symbol::OP_NEG;
+    auto l = r.line();
+    auto c = r.column();
+    if (is_neg) {
+        r.next();
+    }
+
+    if (!expect<token::symbol::LPAREN>(r)) {
+        r = backup;
+        return nullptr;
+    }
+
+    stuck = false;
+    auto e = bool_expr(memo, r, 1, stuck);
+    if (!e || !expect<token::symbol::RPAREN>(r)) {
+        r = backup;
+        return nullptr;
+    }
+
+    if (is_neg) {
+        return ast::make_bool_expr<ast::NegExpr>(l, c, std::move(e));
+    } else {
+        return e;
+    }
+}
+
+static BoolExprPtr bool_expr(
+    parens& memo, token_cursor& r, unsigned min_prec, bool& stuck)
+{
+    auto e1 = relop_expr(memo, r);
+    if (!e1) {
+        return nullptr;
+    }
+
+    while (!stuck) {
+        auto op = r.symbol();
+        unsigned prec = op == token::symbol::OP_OR ? 1 :
+            op == token::symbol::OP_AND ? 2 : 0;
+        if (prec == 0 || prec < min_prec) {
+            break;
+        }
+
+        auto backup = r;
+        auto l = r.line();
+        auto c = r.column();
+        r.next();
+        auto e2 = bool_expr(memo, r, prec + 1, stuck);
+        if (!e2) {
+            r = backup;
+            stuck = true;
+            break;
+        }
+        if (op == token::symbol::OP_OR) {
+            e1 = ast::make_bool_expr<ast::OrExpr>(
+                l, c, std::move(e1), std::move(e2));
+        } else {
+            e1 = ast::make_bool_expr<ast::AndExpr>(
+                l, c, std::move(e1), std::move(e2));
+        }
+    }
+    return e1;
+}
+
+static BoolExprPtr or_expr(token_cursor& r)
+{
+    parens memo;
+    bool stuck = false;
+    return bool_expr(memo, r, 1, stuck);
 }
 
-std::vector<ast::ProgramStatement> parse(std::string_view input)
+} // namespace climbing
+
+// Parses the statements from `r` up to `end` (or to the end of the input)
+static std::vector<ast::ProgramStatement> parse_statements(
+    token_cursor r, std::optional<token_cursor> end, std::size_t size_hint,
+    ParseStats* stats = nullptr)
 {
     std::vector<ast::ProgramStatement> ret;
 
-    for (reader r{input} ; r.symbol() != token::symbol::END ;) {
+    // Expression nodes of this parse share one arena. Its first chunk is sized
+    // after the input; further chunks grow geometrically.
+    ast::ArenaScope arena{std::max<std::size_t>(4096, size_hint * 8)};
+
+#if !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+    // Reused by every statement
+    recursion_context::cache_type parse_cache;
+#endif // !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+
+    while (r.symbol() != token::symbol::END && (!end || r < *end)) {
 #if defined(FEKAL_DISABLE_PEG_MEMOIZATION)
         recursion_context recur{r};
 #else // defined(FEKAL_DISABLE_PEG_MEMOIZATION)
-        recursion_context::cache_type parse_cache;
+        parse_cache.reset(r);
         recursion_context recur{parse_cache, r};
 #endif // defined(FEKAL_DISABLE_PEG_MEMOIZATION)
 
+        auto stmt = recur.enter<ProgramStatement>(r);
+#if !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+        if (stats) {
+            stats->memo_entries += parse_cache.size();
+            stats->memo_bytes = std::max(
+                stats->memo_bytes, parse_cache.memory());
+        }
+#endif // !defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+
         std::visit(hana::overload(
             [](std::monostate&&) {
                 throw std::runtime_error{"no match"}; },
             [&](auto&& stmt) { ret.emplace_back(std::move(stmt)); }
-        ), recur.enter<ProgramStatement>(r));
+        ), std::move(stmt));
+    }
+
+    return ret;
+}
+
+// Cursors at the start of top-level statements, at least `size` bytes apart.
+// A `}` that closes at depth 0 always ends a statement (a policy or an action
+// block), so the token after it starts the next one.
+//
+// Scanning stops at the first lexer error. The remainder then goes in the
+// last chunk, whose parse reports the error where a sequential parse would.
+static std::vector<token_cursor> split(
+    token_cursor r, std::string_view input, std::size_t size)
+{
+    auto offset = [&](const token_cursor& r) {
+        return input.size() - r.tail().size();
+    };
+
+    std::vector<token_cursor> ret;
+    try {
+        ret.push_back(r);
+        unsigned depth = 0;
+        for (; r.symbol() != token::symbol::END ; r.next()) {
+            if (r.symbol() == token::symbol::LBRACE) {
+                ++depth;
+            } else if (
+                r.symbol() == token::symbol::RBRACE && depth > 0 &&
+                --depth == 0
+            ) {
+                auto next = r;
+                next.next();
+                if (
+                    next.symbol() != token::symbol::END &&
+                    offset(next) - offset(ret.back()) >= size
+                ) {
+                    ret.push_back(next);
+                }
+            }
+        }
+    } catch (const std::runtime_error&) {}
+    return ret;
+}
+
+// Below this, a chunk isn't worth a thread
+static constexpr std::size_t min_chunk = 64 * 1024;
+
+std::vector<ast::ProgramStatement> parse(
+    std::string_view input, unsigned jobs)
+{
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Lexed once, so backtracking never runs the lexer again. Chunks share the
+    // array.
+    TokenArray tokens{input};
+    token_cursor first{tokens};
+    if (jobs == 1 || input.size() < 2 * min_chunk) {
+        return parse_statements(first, std::nullopt, input.size());
+    }
+
+    auto starts = split(
+        first, input, std::max(min_chunk, input.size() / jobs));
+    if (starts.size() == 1) {
+        return parse_statements(starts[0], std::nullopt, input.size());
+    }
+
+    std::vector<std::vector<ast::ProgramStatement>> chunks(starts.size());
+    std::vector<std::exception_ptr> errors(starts.size());
+    auto run = [&](std::size_t i) {
+        std::optional<token_cursor> end;
+        auto size = starts[i].tail().size();
+        if (i + 1 < starts.size()) {
+            end = starts[i + 1];
+            size -= end->tail().size();
+        }
+        try {
+            chunks[i] = parse_statements(starts[i], end, size);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1 ; i < starts.size() ; ++i) {
+        threads.emplace_back(run, i);
+    }
+    run(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // the error a sequential parse would have hit first
+    for (const auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
     }
 
+    std::size_t n = 0;
+    for (const auto& chunk : chunks) {
+        n += chunk.size();
+    }
+    std::vector<ast::ProgramStatement> ret;
+    ret.reserve(n);
+    for (auto& chunk : chunks) {
+        std::ranges::move(chunk, std::back_inserter(ret));
+    }
     return ret;
 }
 
+std::vector<ast::ProgramStatement> parse(
+    std::string_view input, ParseStats& stats)
+{
+    stats = {};
+    TokenArray tokens{input};
+    stats.tokens = tokens.tokens().size();
+    token_cursor first{tokens};
+    return parse_statements(first, std::nullopt, input.size(), &stats);
+}
+
+std::pair<std::shared_ptr<ast::BoolExpr>, std::size_t> parse_expression(
+    std::string_view input, ExpressionParser parser)
+{
+    TokenArray tokens{input};
+    token_cursor r{tokens};
+    ast::ArenaScope arena;
+
+    BoolExprPtr e = nullptr;
+    switch (parser) {
+    case ExpressionParser::peg: {
+#if defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+        recursion_context recur{r};
+#else // defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+        recursion_context::cache_type parse_cache;
+        recursion_context recur{parse_cache, r};
+#endif // defined(FEKAL_DISABLE_PEG_MEMOIZATION)
+        e = recur.enter<OrExpr>(r);
+        break;
+    }
+    case ExpressionParser::precedence_climbing:
+        e = climbing::or_expr(r);
+        break;
+    }
+    return {
+        e ? ast::share(e) : nullptr,
+        input.size() - r.tail().size() - r.literal().size()};
+}
+
 } // namespace fekal
@@ -0,0 +1,176 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/passes.hpp>
+#include <fekal/simplify.hpp>
+#include <fekal/checker/syscalls/open.hpp>
+#include <stdexcept>
+#include <algorithm>
+#include <charconv>
+#include <format>
+
+namespace fekal {
+
+PassManager::PassManager()
+{
+    add({"syscall-open", 0, SyscallRule{
+        {rules::SyscallOpen::syscalls.begin(),
+         rules::SyscallOpen::syscalls.end()},
+        [](auto& context, auto& diagnostics, auto& filter) {
+            rules::SyscallOpen{context, diagnostics}.check(filter);
+        }}});
+    add({"simplify-guards", 1, IrPass{simplify_guards}});
+    add({"redundant-rules", 1, IrPass{eliminate_redundant_rules}});
+    add({"prune-rules", 1, IrPass{[](auto&, auto& table) {
+        prune_rules(table);
+    }}});
+    add({"binary-dispatch", 2, &CodegenOptions::binary_dispatch});
+    add({"coalesce-ranges", 3, &CodegenOptions::coalesce_ranges});
+    add({"thread-jumps", 1, BpfPass{bpf::thread_jumps}});
+    add({"dce", 1, BpfPass{bpf::eliminate_dead_code}});
+}
+
+void PassManager::add(Pass pass)
+{
+    passes_.push_back(std::move(pass));
+}
+
+void PassManager::set_level(unsigned level)
+{
+    if (level > max_level) {
+        throw std::invalid_argument{
+            std::format("Invalid optimisation level {}", level)};
+    }
+    this->level = level;
+}
+
+void PassManager::set_enabled(std::string_view pass, bool enabled)
+{
+    auto it = std::ranges::find(passes_, pass, &Pass::name);
+    if (it == passes_.end()) {
+        throw std::invalid_argument{std::format("Unknown pass `{}`", pass)};
+    }
+    overrides[it->name] = enabled;
+}
+
+bool PassManager::enabled(const Pass& pass) const
+{
+    if (auto it = overrides.find(pass.name) ; it != overrides.end()) {
+        return it->second;
+    }
+    return pass.level <= level;
+}
+
+bool PassManager::parse_option(std::string_view arg)
+{
+    if (arg.starts_with("-O")) {
+        auto v = arg.substr(2);
+        unsigned level;
+        auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), level);
+        if (ec != std::errc{} || ptr != v.data() + v.size()) {
+            throw std::invalid_argument{
+                std::format("Invalid optimisation level `{}`", v)};
+        }
+        set_level(level);
+        return true;
+    } else if (arg.starts_with("-j")) {
+        auto v = arg.substr(2);
+        if (v.empty()) {
+            jobs = 0;
+            return true;
+        }
+        auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), jobs);
+        if (ec != std::errc{} || ptr != v.data() + v.size()) {
+            throw std::invalid_argument{
+                std::format("Invalid number of jobs `{}`", v)};
+        }
+        return true;
+    } else if (arg.starts_with("-fno-")) {
+        set_enabled(arg.substr(5), false);
+        return true;
+    } else if (arg.starts_with("-f")) {
+        set_enabled(arg.substr(2), true);
+        return true;
+    }
+    return false;
+}
+
+template<class F, class... Args>
+void PassManager::run_stage(Args&... args)
+{
+    for (const auto& pass : passes_) {
+        auto f = std::get_if<F>(&pass.run);
+        if (!f || !enabled(pass)) {
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        (*f)(args...);
+        if (time_passes) {
+            timings.push_back(Timing{
+                pass.name, std::chrono::steady_clock::now() - start});
+        }
+    }
+}
+
+void PassManager::run(
+    Context& context, Diagnostics& diagnostics,
+    std::vector<ast::ProgramStatement>& ast)
+{
+    // Syscall rules share a single walk, done before AST passes get to
+    // rewrite the program
+    RuleSet rules;
+    for (const auto& pass : passes_) {
+        auto rule = std::get_if<SyscallRule>(&pass.run);
+        if (rule && enabled(pass)) {
+            rules.add(*rule);
+        }
+    }
+    if (!rules.empty()) {
+        auto start = std::chrono::steady_clock::now();
+        rules.check(context, diagnostics, ast, jobs);
+        if (time_passes) {
+            timings.push_back(Timing{
+                "syscall-rules", std::chrono::steady_clock::now() - start});
+        }
+    }
+
+    run_stage<AstPass>(context, diagnostics, ast);
+}
+
+void PassManager::run(Diagnostics& diagnostics, ir::DecisionTable& table)
+{
+    run_stage<IrPass>(diagnostics, table);
+}
+
+void PassManager::run(bpf::Program& program)
+{
+    run_stage<BpfPass>(program);
+}
+
+CodegenOptions PassManager::codegen_options() const
+{
+    CodegenOptions options;
+    for (const auto& pass : passes_) {
+        auto option = std::get_if<LoweringOption>(&pass.run);
+        if (option && enabled(pass)) {
+            options.*(*option) = true;
+        }
+    }
+    return options;
+}
+
+void PassManager::print_timings(std::ostream& out) const
+{
+    std::chrono::nanoseconds total{0};
+    for (const auto& t : timings) {
+        total += t.elapsed;
+    }
+    for (const auto& t : timings) {
+        std::chrono::duration<double, std::micro> us = t.elapsed;
+        out << std::format("{:<20} {:>10.1f} us\n", t.pass, us.count());
+    }
+    std::chrono::duration<double, std::micro> us = total;
+    out << std::format("{:<20} {:>10.1f} us\n", "total", us.count());
+}
+
+} // namespace fekal
@@ -133,7 +133,7 @@ private:
             std::vector<std::string> names;
             names.reserve(filter.params.size());
             for (const auto& id : filter.params) {
-                names.push_back(id.value);
+                names.emplace_back(id.value);
             }
             std::string params = boost::algorithm::join(names, ", ");
             write(std::format("({}) {{\n", params));
@@ -180,14 +180,15 @@ private:
     void visit(const ast::UseStatement& stmt)
     {
         level++;
-        writeln(std::format("UseStatement{{{}}}\n", stmt.id()));
+        writeln(std::format(
+            "UseStatement{{{}{}}}\n", stmt.policy, stmt.version));
         level--;
     }
 
     void visit(const ast::Policy& policy)
     {
         level++;
-        writeln(std::format("Policy {} {{\n", policy.id()));
+        writeln(std::format("Policy {}{} {{\n", policy.name, policy.version));
     }
 
     void visit_leave(const ast::Policy& policy)
@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/checker/rules.hpp>
+#include <boost/hana/functional/overload.hpp>
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <tuple>
+
+namespace fekal {
+
+namespace hana = boost::hana;
+
+void RuleSet::add(const SyscallRule& rule)
+{
+    for (auto syscall : rule.syscalls) {
+        rules[intern(syscall)].push_back(&rule);
+    }
+}
+
+// Below this many filters per thread, starting threads costs more than it
+// saves
+static constexpr std::size_t min_chunk = 64;
+
+void RuleSet::check(
+    Context& context, Diagnostics& diagnostics,
+    const std::vector<ast::ProgramStatement>& ast, unsigned jobs) const
+{
+    using Work = std::pair<
+        const ast::SyscallFilter*, const std::vector<const SyscallRule*>*>;
+    std::vector<Work> work;
+
+    auto block = [&](const ast::ActionBlock& block) {
+        for (const auto& filter : block.filters) {
+            if (auto it = rules.find(filter.symbol) ; it != rules.end()) {
+                work.emplace_back(&filter, &it->second);
+            }
+        }
+    };
+
+    for (const auto& stmt : ast) {
+        std::visit(hana::overload(
+            [&](const ast::Policy& policy) {
+                if (!context.is_reachable(policy)) {
+                    return;
+                }
+                for (const auto& stmt : policy.body) {
+                    if (auto b = std::get_if<ast::ActionBlock>(&stmt) ; b) {
+                        block(*b);
+                    }
+                }
+            },
+            [&](const ast::ActionBlock& b) { block(b); },
+            [](const auto&) {}
+        ), stmt);
+    }
+
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto nchunks = std::clamp<std::size_t>(work.size() / min_chunk, 1, jobs);
+
+    std::vector<Diagnostics> buffers(nchunks);
+    std::vector<std::exception_ptr> errors(nchunks);
+    auto run = [&](std::size_t i) {
+        auto begin = work.begin() + i * work.size() / nchunks;
+        auto end = work.begin() + (i + 1) * work.size() / nchunks;
+        try {
+            for (auto it = begin ; it != end ; ++it) {
+                for (const auto* rule : *it->second) {
+                    rule->check(context, buffers[i], *it->first);
+                }
+            }
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1 ; i < nchunks ; ++i) {
+        threads.emplace_back(run, i);
+    }
+    run(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (const auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    auto first = diagnostics.logs.size();
+    for (auto& buffer : buffers) {
+        std::ranges::move(buffer.logs, std::back_inserter(diagnostics.logs));
+    }
+    std::stable_sort(
+        diagnostics.logs.begin() + first, diagnostics.logs.end(),
+        [](const Log& a, const Log& b) {
+            return std::tie(a.range.start.line, a.range.start.column) <
+                std::tie(b.range.start.line, b.range.start.column);
+        });
+}
+
+} // namespace fekal
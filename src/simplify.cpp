@@ -0,0 +1,466 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/simplify.hpp>
+#include <boost/hana/functional/overload.hpp>
+#include <algorithm>
+#include <optional>
+#include <format>
+#include <limits>
+#include <bit>
+#include <set>
+
+namespace fekal {
+
+namespace hana = boost::hana;
+
+namespace {
+
+constexpr auto u64_max = std::numeric_limits<std::uint64_t>::max();
+
+// Set of values an expression may take
+struct Value
+{
+    std::uint64_t lo = 0;
+    std::uint64_t hi = u64_max;
+
+    // Bits known to be clear and set
+    std::uint64_t zeros = 0;
+    std::uint64_t ones = 0;
+
+    static Value constant(std::uint64_t v)
+    {
+        return Value{v, v, ~v, v};
+    }
+
+    std::optional<std::uint64_t> as_constant() const
+    {
+        if (lo == hi) {
+            return lo;
+        }
+        return std::nullopt;
+    }
+
+    // Tightens the interval and the known bits against each other. Returns
+    // false if no value is left.
+    bool normalize()
+    {
+        if (zeros & ones) {
+            return false;
+        }
+        lo = std::max(lo, ones);
+        hi = std::min(hi, ~zeros);
+        if (lo > hi) {
+            return false;
+        }
+
+        // bits above the highest one differing between lo and hi are fixed
+        auto width = std::bit_width(lo ^ hi);
+        auto fixed = width == 64 ? 0 : u64_max << width;
+        ones |= lo & fixed;
+        zeros |= ~lo & fixed;
+        return (zeros & ones) == 0;
+    }
+};
+
+// Keyed by parameter name. Absent parameters may take any value.
+using Env = std::map<std::string_view, Value>;
+
+bool has_identifiers(const ast::IntExpr& e)
+{
+    return std::visit(hana::overload(
+        [](const ast::IntLit&) { return false; },
+        [](const ast::Identifier&) { return true; },
+        [](const auto& e) {
+            return has_identifiers(*e.left) || has_identifiers(*e.right); }
+    ), e);
+}
+
+Value abstract(const ast::IntExpr& e, const Env& env)
+{
+    if (!has_identifiers(e)) {
+        return Value::constant(eval(e));
+    }
+
+    Value ret;
+    std::visit(hana::overload(
+        [&](const ast::Identifier& id) {
+            if (auto it = env.find(id.value) ; it != env.end()) {
+                ret = it->second;
+            }
+        },
+        [&](const ast::BitAndExpr& e) {
+            auto a = abstract(*e.left, env);
+            auto b = abstract(*e.right, env);
+            ret.ones = a.ones & b.ones;
+            ret.zeros = a.zeros | b.zeros;
+            ret.hi = std::min(a.hi, b.hi);
+        },
+        [&](const ast::BitOrExpr& e) {
+            auto a = abstract(*e.left, env);
+            auto b = abstract(*e.right, env);
+            ret.ones = a.ones | b.ones;
+            ret.zeros = a.zeros & b.zeros;
+            ret.lo = std::max(a.lo, b.lo);
+        },
+        [&](const ast::BitXorExpr& e) {
+            auto a = abstract(*e.left, env);
+            auto b = abstract(*e.right, env);
+            auto known = (a.ones | a.zeros) & (b.ones | b.zeros);
+            auto value = a.ones ^ b.ones;
+            ret.ones = value & known;
+            ret.zeros = ~value & known;
+        },
+        // arithmetic on arguments is rejected by lowering
+        [](const auto&) {}
+    ), e);
+    ret.normalize();
+    return ret;
+}
+
+enum class Cmp { EQ, NEQ, LT, GT, LTE, GTE };
+
+Cmp negate(Cmp op)
+{
+    switch (op) {
+    case Cmp::EQ: return Cmp::NEQ;
+    case Cmp::NEQ: return Cmp::EQ;
+    case Cmp::LT: return Cmp::GTE;
+    case Cmp::GT: return Cmp::LTE;
+    case Cmp::LTE: return Cmp::GT;
+    case Cmp::GTE: return Cmp::LT;
+    }
+    return op;
+}
+
+// Operator of `b op' a` given `a op b`
+Cmp swap(Cmp op)
+{
+    switch (op) {
+    case Cmp::LT: return Cmp::GT;
+    case Cmp::GT: return Cmp::LT;
+    case Cmp::LTE: return Cmp::GTE;
+    case Cmp::GTE: return Cmp::LTE;
+    default: return op;
+    }
+}
+
+struct Comparison
+{
+    Cmp op;
+    const ast::IntExpr* left;
+    const ast::IntExpr* right;
+};
+
+std::optional<Comparison> as_comparison(const ast::BoolExpr& expr)
+{
+    return std::visit(hana::overload(
+        [](const ast::EqExpr& e) -> std::optional<Comparison> {
+            return Comparison{Cmp::EQ, e.left, e.right}; },
+        [](const ast::NeqExpr& e) -> std::optional<Comparison> {
+            return Comparison{Cmp::NEQ, e.left, e.right}; },
+        [](const ast::LtExpr& e) -> std::optional<Comparison> {
+            return Comparison{Cmp::LT, e.left, e.right}; },
+        [](const ast::GtExpr& e) -> std::optional<Comparison> {
+            return Comparison{Cmp::GT, e.left, e.right}; },
+        [](const ast::LteExpr& e) -> std::optional<Comparison> {
+            return Comparison{Cmp::LTE, e.left, e.right}; },
+        [](const ast::GteExpr& e) -> std::optional<Comparison> {
+            return Comparison{Cmp::GTE, e.left, e.right}; },
+        [](const auto&) -> std::optional<Comparison> { return std::nullopt; }
+    ), expr);
+}
+
+std::optional<bool> decide(Cmp op, const Value& a, const Value& b)
+{
+    switch (op) {
+    case Cmp::EQ:
+    case Cmp::NEQ: {
+        std::optional<bool> eq;
+        if (a.as_constant() && a.as_constant() == b.as_constant()) {
+            eq = true;
+        } else if (
+            a.hi < b.lo || b.hi < a.lo ||
+            (a.ones & b.zeros) || (a.zeros & b.ones)
+        ) {
+            eq = false;
+        }
+        if (eq && op == Cmp::NEQ) {
+            eq = !*eq;
+        }
+        return eq;
+    }
+    case Cmp::LT:
+        if (a.hi < b.lo) return true;
+        if (a.lo >= b.hi) return false;
+        break;
+    case Cmp::GT:
+        if (a.lo > b.hi) return true;
+        if (a.hi <= b.lo) return false;
+        break;
+    case Cmp::LTE:
+        if (a.hi <= b.lo) return true;
+        if (a.lo > b.hi) return false;
+        break;
+    case Cmp::GTE:
+        if (a.lo >= b.hi) return true;
+        if (a.hi < b.lo) return false;
+        break;
+    }
+    return std::nullopt;
+}
+
+// Narrows `v` to the values satisfying `v op c`. Returns false if none does.
+bool constrain(Value& v, Cmp op, std::uint64_t c)
+{
+    switch (op) {
+    case Cmp::EQ:
+        v.lo = std::max(v.lo, c);
+        v.hi = std::min(v.hi, c);
+        break;
+    case Cmp::NEQ:
+        if (v.lo == c && v.hi == c) {
+            return false;
+        } else if (v.lo == c) {
+            ++v.lo;
+        } else if (v.hi == c) {
+            --v.hi;
+        }
+        break;
+    case Cmp::LT:
+        if (c == 0) {
+            return false;
+        }
+        v.hi = std::min(v.hi, c - 1);
+        break;
+    case Cmp::GT:
+        if (c == u64_max) {
+            return false;
+        }
+        v.lo = std::max(v.lo, c + 1);
+        break;
+    case Cmp::LTE:
+        v.hi = std::min(v.hi, c);
+        break;
+    case Cmp::GTE:
+        v.lo = std::max(v.lo, c);
+        break;
+    }
+    return v.normalize();
+}
+
+// Narrows the arguments to the values under which `expr` evaluates to
+// `truth`. Only `x op c` and `(x & m) == c` are understood. Returns false if
+// no value is left.
+bool refine(const ast::BoolExpr& expr, bool truth, Env& env)
+{
+    auto cmp = as_comparison(expr);
+    if (!cmp) {
+        return std::visit(hana::overload(
+            [&](const ast::NegExpr& e) { return refine(*e.inner, !truth, env); },
+            [&](const ast::AndExpr& e) {
+                return !truth ||
+                    (refine(*e.left, true, env) && refine(*e.right, true, env));
+            },
+            [&](const ast::OrExpr& e) {
+                return truth ||
+                    (refine(*e.left, false, env) &&
+                     refine(*e.right, false, env));
+            },
+            [](const auto&) { return true; }
+        ), expr);
+    }
+
+    auto op = truth ? cmp->op : negate(cmp->op);
+    auto var = cmp->left;
+    auto rhs = cmp->right;
+    if (!has_identifiers(*var)) {
+        std::swap(var, rhs);
+        op = swap(op);
+    }
+    if (has_identifiers(*rhs)) {
+        return true;
+    }
+    auto c = eval(*rhs);
+
+    if (auto id = std::get_if<ast::Identifier>(var) ; id) {
+        return constrain(env[id->value], op, c);
+    }
+
+    auto masked = std::get_if<ast::BitAndExpr>(var);
+    if (!masked || op != Cmp::EQ) {
+        return true;
+    }
+    auto id = std::get_if<ast::Identifier>(masked->left);
+    auto mask = masked->right;
+    if (!id) {
+        id = std::get_if<ast::Identifier>(masked->right);
+        mask = masked->left;
+    }
+    if (!id || has_identifiers(*mask)) {
+        return true;
+    }
+    auto m = eval(*mask);
+    if (c & ~m) {
+        return false;
+    }
+    auto& v = env[id->value];
+    v.ones |= c;
+    v.zeros |= m & ~c;
+    return v.normalize();
+}
+
+const ast::NodeBase& node_of(const ast::BoolExpr& expr)
+{
+    return std::visit(
+        [](const auto& e) -> const ast::NodeBase& { return e; }, expr);
+}
+
+// Either decided at compile time or the expression left to test
+using Folded = std::variant<bool, ast::BoolExpr*>;
+
+struct Simplifier
+{
+    Diagnostics& diagnostics;
+
+    // Archs share the guards of the same source
+    std::set<std::pair<unsigned, unsigned>> reported;
+
+    // `written` is the same expression as written in the source, if known.
+    // Interned nodes are shared by every occurrence, so positions come from
+    // there.
+    Folded simplify(ast::BoolExpr* expr, const ast::BoolExpr* written,
+                    const Env& env)
+    {
+        if (written && written->index() != expr->index()) {
+            written = nullptr;
+        }
+
+        if (auto cmp = as_comparison(*expr) ; cmp) {
+            auto r = decide(
+                cmp->op, abstract(*cmp->left, env), abstract(*cmp->right, env));
+            if (!r) {
+                return expr;
+            }
+            const auto& node = node_of(written ? *written : *expr);
+            if (reported.emplace(node.line, node.column).second) {
+                diagnostics.warning(
+                    std::format("Comparison is always {}", *r),
+                    diagnostics.rangeFromName(node, ""));
+            }
+            return *r;
+        }
+
+        return std::visit(hana::overload(
+            [&](const ast::NegExpr& e) -> Folded {
+                auto w = written ? &std::get<ast::NegExpr>(*written) : nullptr;
+                auto inner = simplify(e.inner, w ? w->inner : nullptr, env);
+                if (auto b = std::get_if<bool>(&inner) ; b) {
+                    return !*b;
+                }
+                auto p = std::get<1>(inner);
+                if (p == e.inner) {
+                    return expr;
+                }
+                return ast::make_bool_expr<ast::NegExpr>(e.line, e.column, p);
+            },
+            [&](const ast::AndExpr& e) -> Folded {
+                return binary<ast::AndExpr>(expr, e, written, true, env);
+            },
+            [&](const ast::OrExpr& e) -> Folded {
+                return binary<ast::OrExpr>(expr, e, written, false, env);
+            },
+            [&](const auto&) -> Folded { return expr; }
+        ), *expr);
+    }
+
+    // `identity` is the value of the right operand that leaves the left one
+    // unchanged (true for AND, false for OR)
+    template<class E>
+    Folded binary(
+        ast::BoolExpr* expr, const E& e, const ast::BoolExpr* written,
+        bool identity, const Env& env)
+    {
+        auto w = written ? &std::get<E>(*written) : nullptr;
+        auto left = simplify(e.left, w ? w->left : nullptr, env);
+        if (auto b = std::get_if<bool>(&left) ; b && *b != identity) {
+            return *b;
+        }
+
+        // the right operand is only tested once the left one is `identity`
+        auto narrowed = env;
+        if (!refine(*e.left, identity, narrowed)) {
+            return !identity;
+        }
+        auto right = simplify(e.right, w ? w->right : nullptr, narrowed);
+        if (auto b = std::get_if<bool>(&right) ; b) {
+            if (*b != identity) {
+                return *b;
+            }
+            return left;
+        }
+        if (std::holds_alternative<bool>(left)) {
+            return right;
+        }
+
+        auto l = std::get<1>(left);
+        auto r = std::get<1>(right);
+        if (l == e.left && r == e.right) {
+            return expr;
+        }
+        return ast::make_bool_expr<E>(e.line, e.column, l, r);
+    }
+};
+
+} // namespace
+
+void simplify_guards(Diagnostics& diagnostics, ir::DecisionTable& table)
+{
+    // a fresh arena for the rewritten guards, which keeps the nodes they
+    // share with the old ones alive
+    ast::ArenaScope arena;
+    Simplifier simplifier{diagnostics, {}};
+    for (auto& t : table.archs) {
+        for (auto& [nr, syscall] : t.syscalls) {
+            std::erase_if(syscall.entries, [&](ir::Entry& entry) {
+                auto& guard = entry.guard;
+                if (entry.unconditional()) {
+                    return false;
+                }
+
+                // alternatives are tested in order, so each one may assume
+                // the previous ones failed
+                Env env;
+                std::vector<std::shared_ptr<ast::BoolExpr>> body;
+                bool positions = entry.written.size() == guard.body.size();
+                for (std::size_t i = 0 ; i < guard.body.size() ; ++i) {
+                    const auto& expr = guard.body[i];
+                    auto folded = simplifier.simplify(
+                        expr.get(),
+                        positions ? entry.written[i].get() : nullptr, env);
+                    if (auto b = std::get_if<bool>(&folded) ; b) {
+                        if (*b) {
+                            guard.body.clear();
+                            entry.written.clear();
+                            return false;
+                        }
+                        continue;
+                    }
+                    body.push_back(ast::share(std::get<1>(folded), expr));
+                    if (!refine(*expr, false, env)) {
+                        break;
+                    }
+                }
+                if (body != guard.body) {
+                    entry.written.clear();
+                }
+                guard.body = std::move(body);
+
+                // never matches
+                return guard.body.empty();
+            });
+        }
+    }
+}
+
+} // namespace fekal
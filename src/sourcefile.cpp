@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/sourcefile.hpp>
+#include <system_error>
+#include <utility>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+namespace fekal {
+
+SourceFile::SourceFile(std::string text)
+    : buffer{std::make_unique_for_overwrite<char[]>(text.size())}
+    , buffer_size{text.size()}
+{
+    text.copy(buffer.get(), text.size());
+}
+
+SourceFile SourceFile::open(const char* path)
+{
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::system_error{errno, std::system_category(), path};
+    }
+
+    SourceFile ret;
+    auto fail = [&]() {
+        int e = errno;
+        ::close(fd);
+        throw std::system_error{e, std::system_category(), path};
+    };
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        fail();
+    }
+
+    // mmap() rejects empty mappings
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ret.mapping = p;
+            ret.mapping_size = st.st_size;
+            ::close(fd);
+            return ret;
+        }
+    }
+
+    std::string text;
+    char chunk[4096];
+    for (;;) {
+        auto n = ::read(fd, chunk, sizeof(chunk));
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fail();
+        }
+        if (n == 0) {
+            break;
+        }
+        text.append(chunk, n);
+    }
+    ::close(fd);
+    return SourceFile{std::move(text)};
+}
+
+SourceFile::SourceFile(SourceFile&& o) noexcept
+    : buffer{std::move(o.buffer)}
+    , buffer_size{std::exchange(o.buffer_size, 0)}
+    , mapping{std::exchange(o.mapping, nullptr)}
+    , mapping_size{std::exchange(o.mapping_size, 0)}
+{}
+
+SourceFile& SourceFile::operator=(SourceFile&& o) noexcept
+{
+    if (this != &o) {
+        if (mapping) {
+            munmap(mapping, mapping_size);
+        }
+        buffer = std::move(o.buffer);
+        buffer_size = std::exchange(o.buffer_size, 0);
+        mapping = std::exchange(o.mapping, nullptr);
+        mapping_size = std::exchange(o.mapping_size, 0);
+    }
+    return *this;
+}
+
+SourceFile::~SourceFile()
+{
+    if (mapping) {
+        munmap(mapping, mapping_size);
+    }
+}
+
+std::string_view SourceFile::text() const
+{
+    if (mapping) {
+        return {static_cast<const char*>(mapping), mapping_size};
+    }
+    return {buffer.get(), buffer_size};
+}
+
+} // namespace fekal
@@ -0,0 +1,67 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/symbols.hpp>
+#include <unordered_map>
+#include <shared_mutex>
+#include <string>
+#include <deque>
+#include <mutex>
+
+namespace fekal {
+
+namespace {
+
+struct Interner
+{
+    Interner()
+    {
+        intern("_");
+    }
+
+    // Callers hold the lock
+    SymbolId intern(std::string_view name)
+    {
+        if (auto it = ids.find(name) ; it != ids.end()) {
+            return it->second;
+        }
+        SymbolId id = spellings.size();
+        // deque elements never move, so keys may view them
+        ids.emplace(spellings.emplace_back(name), id);
+        return id;
+    }
+
+    std::shared_mutex mutex;
+    std::deque<std::string> spellings;
+    std::unordered_map<std::string_view, SymbolId> ids;
+};
+
+Interner& interner()
+{
+    static Interner ret;
+    return ret;
+}
+
+} // namespace
+
+SymbolId intern(std::string_view name)
+{
+    auto& in = interner();
+    {
+        std::shared_lock lk{in.mutex};
+        if (auto it = in.ids.find(name) ; it != in.ids.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock lk{in.mutex};
+    return in.intern(name);
+}
+
+std::string_view spelling(SymbolId id)
+{
+    auto& in = interner();
+    std::shared_lock lk{in.mutex};
+    return in.spellings.at(id);
+}
+
+} // namespace fekal
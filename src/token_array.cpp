@@ -0,0 +1,59 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/token_array.hpp>
+#include <stdexcept>
+#include <limits>
+
+namespace fekal {
+
+TokenArray::TokenArray(std::string_view input)
+    : input_{input}
+{
+    if (input.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error{"input too large"};
+    }
+
+    try {
+        reader r{input};
+        for (;;) {
+            auto literal = r.literal();
+            tokens_.push_back(Token{
+                .symbol = r.symbol(),
+                .offset = static_cast<std::uint32_t>(
+                    literal.data() - input.data()),
+                .length = static_cast<std::uint32_t>(literal.size()),
+                .line = r.line(),
+                .column = r.column(),
+            });
+            if (r.symbol() == token::symbol::END) {
+                break;
+            }
+            r.next();
+        }
+    } catch (const std::runtime_error&) {
+        error_ = std::current_exception();
+    }
+}
+
+token_cursor::token_cursor(const TokenArray& tokens)
+    : tokens{&tokens}
+{
+    if (tokens.tokens().empty()) {
+        std::rethrow_exception(tokens.error());
+    }
+}
+
+bool token_cursor::next()
+{
+    if (symbol() == token::symbol::END) {
+        return false;
+    }
+    if (index + 1 == tokens->tokens().size()) {
+        std::rethrow_exception(tokens->error());
+    }
+    ++index;
+    return symbol() != token::symbol::END;
+}
+
+} // namespace fekal
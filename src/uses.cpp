@@ -0,0 +1,174 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/uses.hpp>
+#include <boost/hana/functional/overload.hpp>
+#include <unordered_set>
+#include <algorithm>
+#include <format>
+
+namespace fekal {
+
+namespace hana = boost::hana;
+
+UseResolver::UseResolver(const std::vector<ast::ProgramStatement>& ast)
+    : ast{ast}
+{
+    for (const auto& stmt : ast) {
+        if (auto policy = std::get_if<ast::Policy>(&stmt) ; policy) {
+            policies.emplace(policy->key(), policy);
+        }
+    }
+}
+
+std::shared_ptr<const UseResolver::Flattened> UseResolver::resolve(
+    SymbolKey key) const
+{
+    std::vector<SymbolKey> path;
+    return resolve(key, path);
+}
+
+std::shared_ptr<const UseResolver::Flattened> UseResolver::resolve(
+    SymbolKey key, std::vector<SymbolKey>& path) const
+{
+    {
+        std::lock_guard lk{mutex};
+        if (auto it = memo.find(key) ; it != memo.end()) {
+            return it->second;
+        }
+    }
+
+    auto ret = std::make_shared<Flattened>();
+    auto it = policies.find(key);
+    if (it == policies.end()) {
+        return ret;
+    }
+    const auto* policy = it->second;
+
+    // Computed without holding the lock. Should another thread race us, both
+    // results are equal and the first one stored wins.
+    path.push_back(key);
+    std::unordered_set<const ast::Policy*> included{policy};
+    for (const auto& stmt : policy->body) {
+        std::visit(hana::overload(
+            [&](const ast::ActionBlock& block) {
+                ret->push_back(Entry{policy, &block});
+            },
+            [&](const ast::UseStatement& use) {
+                if (std::ranges::find(path, use.key()) != path.end()) {
+                    // cycle, reported by check()
+                    return;
+                }
+                auto sub = resolve(use.key(), path);
+                auto size = ret->size();
+                std::ranges::copy_if(
+                    *sub, std::back_inserter(*ret), [&](const Entry& e) {
+                        return !included.contains(e.policy);
+                    });
+                for (auto i = size ; i < ret->size() ; ++i) {
+                    included.insert((*ret)[i].policy);
+                }
+            }
+        ), stmt);
+    }
+    path.pop_back();
+
+    std::lock_guard lk{mutex};
+    return memo.emplace(key, std::move(ret)).first->second;
+}
+
+std::unordered_set<const ast::Policy*> UseResolver::reachable() const
+{
+    std::unordered_set<const ast::Policy*> ret;
+    std::vector<const ast::Policy*> pending;
+    auto reach = [&](const ast::UseStatement& use) {
+        auto it = policies.find(use.key());
+        if (it != policies.end() && ret.insert(it->second).second) {
+            pending.push_back(it->second);
+        }
+    };
+
+    for (const auto& stmt : ast) {
+        if (auto use = std::get_if<ast::UseStatement>(&stmt) ; use) {
+            reach(*use);
+        }
+    }
+    while (!pending.empty()) {
+        const auto* policy = pending.back();
+        pending.pop_back();
+        for (const auto& stmt : policy->body) {
+            if (auto use = std::get_if<ast::UseStatement>(&stmt) ; use) {
+                reach(*use);
+            }
+        }
+    }
+    return ret;
+}
+
+void UseResolver::check(Diagnostics& diagnostics) const
+{
+    enum class State { VISITING, DONE };
+    std::unordered_map<const ast::Policy*, State> state;
+    std::vector<const ast::Policy*> stack;
+
+    auto check_body = [&](const auto& body, auto& self) -> void {
+        std::unordered_set<SymbolKey> used;
+        for (const auto& stmt : body) {
+            auto use = std::get_if<ast::UseStatement>(&stmt);
+            if (!use) {
+                continue;
+            }
+            if (!used.insert(use->key()).second) {
+                diagnostics.warning(
+                    std::format(
+                        "Policy {} {} already used", use->policy,
+                        use->version),
+                    diagnostics.rangeFromName(*use, use->policy));
+            }
+
+            // unknown policies are reported by the checker
+            auto it = policies.find(use->key());
+            if (it == policies.end()) {
+                continue;
+            }
+            const auto* policy = it->second;
+            auto s = state.find(policy);
+            if (s == state.end()) {
+                state.emplace(policy, State::VISITING);
+                stack.push_back(policy);
+                self(policy->body, self);
+                stack.pop_back();
+                state[policy] = State::DONE;
+            } else if (s->second == State::VISITING) {
+                std::string cycle;
+                auto first = std::ranges::find(stack, policy);
+                for (auto p = first ; p != stack.end() ; ++p) {
+                    cycle += std::format(
+                        "{} {} -> ", (*p)->name, (*p)->version);
+                }
+                cycle += std::format("{} {}", use->policy, use->version);
+                diagnostics.error(
+                    std::format("Cyclic USE: {}", cycle),
+                    diagnostics.rangeFromName(*use, use->policy));
+            }
+        }
+    };
+
+    for (const auto& stmt : ast) {
+        auto policy = std::get_if<ast::Policy>(&stmt);
+        if (
+            !policy || state.contains(policy) ||
+            policies.at(policy->key()) != policy
+        ) {
+            continue;
+        }
+        state.emplace(policy, State::VISITING);
+        stack.push_back(policy);
+        check_body(policy->body, check_body);
+        stack.pop_back();
+        state[policy] = State::DONE;
+    }
+    check_body(ast, check_body);
+}
+
+} // namespace fekal
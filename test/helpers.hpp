@@ -0,0 +1,16 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#pragma once
+
+#include <fekal/diagnostics.hpp>
+#include <algorithm>
+#include <cstddef>
+
+// Logs of `severity` so far
+inline std::size_t count(
+    const fekal::Diagnostics& diagnostics, fekal::Severity severity)
+{
+    return std::ranges::count(
+        diagnostics.logs, severity, &fekal::Log::severity);
+}
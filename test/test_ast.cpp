@@ -1,10 +1,13 @@
 // Copyright (c) 2025 César Augusto D. Azevedo
 // SPDX-License-Identifier: MIT-0
 
-#define BOOST_TEST_MODULE AST
+#define BOOST_TEST_MODULE fekal
 
+#include <fekal/sourcefile.hpp>
+#include <fekal/token_array.hpp>
 #include <fekal/parser.hpp>
 #include <boost/test/included/unit_test.hpp>
+#include <format>
 
 using namespace fekal;
 
@@ -33,6 +36,7 @@ BOOST_AUTO_TEST_CASE(assert_ast_structure)
         }
     )";
     std::vector<ast::ProgramStatement> parsed = fekal::parse(input);
+    ast::ArenaScope arena;
     std::vector<ast::ProgramStatement> expected = {
         ast::Policy(2, 19, "Aio", "0", {
             ast::ActionBlock{
@@ -56,7 +60,7 @@ BOOST_AUTO_TEST_CASE(assert_ast_structure)
                 ast::Action{fekal::ast::ActionAllow{}},
                 {
                     ast::SyscallFilter(13, 27, "personality", {ast::Identifier(13, 28, "persona")}, {
-                        ast::make_bool_expr<ast::OrExpr>(
+                        ast::share(ast::make_bool_expr<ast::OrExpr>(
                             17,
                             34,
                             ast::make_bool_expr<ast::OrExpr>(
@@ -101,7 +105,7 @@ BOOST_AUTO_TEST_CASE(assert_ast_structure)
                                 ast::make_int_expr<ast::Identifier>(18, 20, "persona"),
                                 ast::make_int_expr<ast::IntLit>(18, 31, 24)
                             )
-                        )
+                        ))
                     }),
                 }
             }
@@ -109,3 +113,201 @@ BOOST_AUTO_TEST_CASE(assert_ast_structure)
     };
     BOOST_TEST(parsed == expected);
 }
+
+BOOST_AUTO_TEST_CASE(nodes_outlive_the_parse)
+{
+    std::shared_ptr<ast::BoolExpr> expr;
+    {
+        auto parsed = parse("ALLOW { read(fd) { fd == 3 || fd > 10 } }");
+        expr = std::get<ast::ActionBlock>(parsed.front()).filters.front()
+            .body.front();
+    }
+    BOOST_TEST(eval(*expr, {{"fd", 3}}));
+    BOOST_TEST(!eval(*expr, {{"fd", 4}}));
+    BOOST_TEST(eval(*expr, {{"fd", 11}}));
+}
+
+BOOST_AUTO_TEST_CASE(nodes_need_an_arena)
+{
+    BOOST_CHECK_THROW(
+        ast::make_int_expr<ast::IntLit>(1, 1, 0), std::logic_error);
+
+    ast::ArenaScope arena;
+    auto e = ast::share(ast::make_bool_expr<ast::EqExpr>(
+        1, 1, ast::make_int_expr<ast::IntLit>(1, 1, 2),
+        ast::make_int_expr<ast::IntLit>(1, 6, 2)));
+    BOOST_TEST(eval(*e));
+}
+
+BOOST_AUTO_TEST_CASE(arena_scopes_nest)
+{
+    BOOST_TEST(!ast::current_arena());
+    {
+        ast::ArenaScope outer;
+        auto outer_arena = ast::current_arena();
+        {
+            ast::ArenaScope inner;
+            BOOST_TEST(ast::current_arena() != outer_arena);
+        }
+        BOOST_TEST(ast::current_arena() == outer_arena);
+    }
+    BOOST_TEST(!ast::current_arena());
+}
+
+BOOST_AUTO_TEST_CASE(names_reference_the_source)
+{
+    SourceFile source{"POLICY Io v1 { ALLOW { read(fd) { fd == 0 } } }"};
+    auto text = source.text();
+    auto within = [&](std::string_view name) {
+        return name.data() >= text.data() &&
+            name.data() + name.size() <= text.data() + text.size();
+    };
+
+    auto parsed = parse(text);
+    const auto& policy = std::get<ast::Policy>(parsed.front());
+    const auto& filter = std::get<ast::ActionBlock>(policy.body.front())
+        .filters.front();
+    const auto& cmp = std::get<ast::EqExpr>(*filter.body.front());
+
+    BOOST_TEST(within(policy.name));
+    BOOST_TEST(policy.version == "v1");
+    BOOST_TEST(within(policy.version));
+    BOOST_TEST(within(filter.syscall));
+    BOOST_TEST(within(filter.params.front().value));
+    BOOST_TEST(within(std::get<ast::Identifier>(*cmp.left).value));
+}
+
+BOOST_AUTO_TEST_CASE(moves_keep_short_sources_in_place)
+{
+    SourceFile source{"ALLOW { read }"};
+    auto parsed = parse(source.text());
+    const auto& syscall = std::get<ast::ActionBlock>(parsed.front())
+        .filters.front().syscall;
+
+    SourceFile moved{std::move(source)};
+    BOOST_TEST(syscall.data() == moved.text().data() + 8);
+    source = std::move(moved);
+    BOOST_TEST(syscall == "read");
+}
+
+static std::string generated_policies(unsigned n)
+{
+    std::string ret = "DEFAULT ERRNO(1)\n";
+    for (unsigned i = 0 ; i < n ; ++i) {
+        ret += std::format(
+            "// policy {} }}\n"
+            "POLICY P{} 0 {{\n"
+            "    /* {{ not a brace\n"
+            "       }} */ ALLOW {{ read(fd) {{ fd == {} }}, close }}\n"
+            "}}\n"
+            "USE P{} 0\n"
+            "ERRNO(2) {{ ioctl(fd, request) {{ request == {} && fd > 2 }} }}\n",
+            i, i, i, i, i);
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(parallel_parse_matches_sequential)
+{
+    auto source = generated_policies(3000);
+    BOOST_REQUIRE(source.size() > 256u * 1024u);
+
+    auto expected = parse(source);
+    BOOST_TEST(expected.size() == 1u + 3u * 3000u);
+    for (unsigned jobs : {2u, 5u, 0u}) {
+        BOOST_TEST((parse(source, jobs) == expected));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_parse_reports_the_first_error)
+{
+    auto source = generated_policies(3000);
+    // a syntax error, then a lexer error in a later chunk
+    source.insert(source.find("USE", source.size() / 3), "USE USE\n");
+    source.insert(source.find("USE", source.size() * 2 / 3), "\t");
+
+    auto message = [&](unsigned jobs) -> std::string {
+        try {
+            parse(source, jobs);
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return {};
+    };
+    // tokens are lexed up front, but the lexer error still comes second
+    auto expected = message(1);
+    BOOST_TEST(expected == "no match");
+    BOOST_TEST(message(4) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(token_cursor_follows_reader)
+{
+    std::string_view source = R"(// comment
+POLICY P 0 { /* multi
+   line */ ALLOW { read(fd) { fd == 0x10 && fd != -1 } }
+}
+ERRNO(EPERM) { write } // trailing)";
+    TokenArray tokens{source};
+    BOOST_TEST(!tokens.error());
+
+    reader r{source};
+    token_cursor c{tokens};
+    for (;;) {
+        BOOST_TEST((c.symbol() == r.symbol()));
+        BOOST_TEST(c.literal() == r.literal());
+        BOOST_TEST(c.tail() == r.tail());
+        BOOST_TEST(c.line() == r.line());
+        BOOST_TEST(c.column() == r.column());
+        BOOST_TEST(c.ordinal() == r.ordinal());
+        if (r.symbol() == token::symbol::END) {
+            break;
+        }
+        BOOST_TEST(c.next() == r.next());
+    }
+    BOOST_TEST(!c.next());
+    BOOST_TEST((c.symbol() == token::symbol::END));
+}
+
+BOOST_AUTO_TEST_CASE(token_cursor_throws_at_the_lexer_error)
+{
+    TokenArray tokens{"ALLOW { read }\t"};
+    BOOST_TEST(static_cast<bool>(tokens.error()));
+
+    token_cursor c{tokens};
+    unsigned n = 0;
+    BOOST_CHECK_THROW(while (c.next()) { ++n; }, std::runtime_error);
+    BOOST_TEST(n == 3u);
+    BOOST_TEST((c.symbol() == token::symbol::RBRACE));
+
+    TokenArray invalid{"\t"};
+    BOOST_TEST(invalid.tokens().empty());
+    BOOST_CHECK_THROW(token_cursor{invalid}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(long_or_chain)
+{
+    std::string source;
+    for (unsigned i = 0 ; i < 5000 ; ++i) {
+        source += std::format("{}fd == {}", i ? " || " : "", i);
+    }
+
+    auto [peg, peg_end] = parse_expression(source, ExpressionParser::peg);
+    auto [climbing, climbing_end] = parse_expression(
+        source, ExpressionParser::precedence_climbing);
+    BOOST_REQUIRE(peg && climbing);
+    BOOST_TEST(peg_end == source.size());
+    BOOST_TEST(climbing_end == source.size());
+    BOOST_TEST((*peg == *climbing));
+
+    // left-associative
+    unsigned depth = 0;
+    for (
+        auto e = climbing.get() ;
+        auto o = std::get_if<ast::OrExpr>(e) ;
+        e = o->left
+    ) {
+        BOOST_REQUIRE(std::holds_alternative<ast::EqExpr>(*o->right));
+        ++depth;
+    }
+    BOOST_TEST(depth == 4999u);
+}
@@ -0,0 +1,171 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/constants.hpp>
+#include <fekal/compiler.hpp>
+#include <fekal/codegen.hpp>
+#include <fekal/parser.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace fekal;
+
+BOOST_AUTO_TEST_SUITE(constant_folding)
+
+static const ast::SyscallFilter& first_filter(
+    const std::vector<ast::ProgramStatement>& ast)
+{
+    return std::get<ast::ActionBlock>(ast.front()).filters.front();
+}
+
+BOOST_AUTO_TEST_CASE(lookup)
+{
+    BOOST_TEST(find_constant("O_CLOEXEC").value() == 02000000u);
+    BOOST_TEST(find_constant("AF_INET6").value() == 10u);
+    BOOST_TEST(find_constant("CLONE_NEWUSER").value() == 0x10000000u);
+    BOOST_TEST(!find_constant("EPERM"));
+    BOOST_TEST(find_errno("EPERM").value() == 1u);
+    BOOST_TEST(!find_errno("O_RDONLY"));
+
+    BOOST_TEST(std::ranges::is_sorted(constants(), {}, &Constant::name));
+}
+
+BOOST_AUTO_TEST_CASE(errno_names)
+{
+    auto ast = parse("ERRNO(EACCES) { read }");
+    const auto& block = std::get<ast::ActionBlock>(ast.front());
+    BOOST_TEST(std::get<ast::ActionErrno>(block.action).errnum == 13);
+}
+
+BOOST_AUTO_TEST_CASE(foldable_subtrees_become_literals)
+{
+    auto ast = parse(R"(
+        ALLOW {
+            socket(domain, type) {
+                domain == AF_INET &&
+                (type & 0xffffffff - (SOCK_NONBLOCK | SOCK_CLOEXEC)) ==
+                    SOCK_STREAM
+            }
+        }
+    )");
+    fold_constants(ast);
+
+    const auto& filter = first_filter(ast);
+    const auto& conj = std::get<ast::AndExpr>(*filter.body.front());
+    const auto& domain = std::get<ast::EqExpr>(*conj.left);
+    BOOST_TEST(std::get<ast::IntLit>(*domain.right).value == 2);
+
+    const auto& type = std::get<ast::EqExpr>(*conj.right);
+    const auto& mask = std::get<ast::BitAndExpr>(*type.left);
+    BOOST_TEST(std::holds_alternative<ast::Identifier>(*mask.left));
+    BOOST_TEST(std::get<ast::IntLit>(*mask.right).value == 0xfff7f7ff);
+    BOOST_TEST(std::get<ast::IntLit>(*type.right).value == 1);
+}
+
+BOOST_AUTO_TEST_CASE(parameters_shadow_constants)
+{
+    auto ast = parse("ALLOW { read(O_RDONLY) { O_RDONLY == O_WRONLY } }");
+    fold_constants(ast);
+
+    const auto& cmp = std::get<ast::EqExpr>(*first_filter(ast).body.front());
+    BOOST_TEST(std::holds_alternative<ast::Identifier>(*cmp.left));
+    BOOST_TEST(std::get<ast::IntLit>(*cmp.right).value == 1);
+}
+
+BOOST_AUTO_TEST_CASE(folded_copies_outlive_the_parse)
+{
+    std::optional<ast::SyscallFilter> folded;
+    {
+        auto ast = parse("ALLOW { read(fd) { fd == O_CLOEXEC || fd > 1 } }");
+        folded = first_filter(ast);
+        fold_constants(*folded);
+    }
+
+    // a new root, over `fd > 1` as parsed
+    const auto& expr = *folded->body.front();
+    BOOST_TEST(eval(expr, {{"fd", 02000000}}));
+    BOOST_TEST(eval(expr, {{"fd", 2}}));
+    BOOST_TEST(!eval(expr, {{"fd", 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(compiled_filter_uses_constant_values)
+{
+    Compiler compiler;
+    auto ast = compiler.compile(
+        "ALLOW { openat(dirfd, path, flags) { (flags & O_CLOEXEC) != 0 } }");
+    auto program = compiler.codegen(ast, std::span{&native_arch(), 1});
+    BOOST_TEST(!compiler.diagnostics.has_errors());
+    BOOST_TEST(!program.empty());
+}
+
+BOOST_AUTO_TEST_CASE(compiled_ast_is_kept_as_written)
+{
+    Compiler compiler;
+    auto ast = compiler.compile(
+        "ALLOW { openat(dirfd, path, flags) { flags == O_CREAT + 1 + 2 } }");
+    auto program = compiler.codegen(ast, std::span{&native_arch(), 1});
+    BOOST_REQUIRE(!program.empty());
+
+    const auto& cmp = std::get<ast::EqExpr>(*first_filter(ast).body.front());
+    const auto& sum = std::get<ast::SumExpr>(*cmp.right);
+    const auto& lhs = std::get<ast::SumExpr>(*sum.left);
+    BOOST_TEST(std::get<ast::Identifier>(*lhs.left).value == "O_CREAT");
+    BOOST_TEST(std::get<ast::IntLit>(*lhs.right).value == 1);
+    BOOST_TEST(std::get<ast::IntLit>(*sum.right).value == 2);
+}
+
+BOOST_AUTO_TEST_CASE(division_by_constant_zero)
+{
+    Compiler compiler;
+    auto ast = compiler.compile("ALLOW { write(fd) { fd == 1 / 0 } }");
+    auto program = compiler.codegen(ast, std::span{&native_arch(), 1});
+    BOOST_TEST(program.empty());
+    BOOST_REQUIRE(compiler.diagnostics.logs.size() == 1u);
+    BOOST_TEST(compiler.diagnostics.logs.front().message == "Division by zero");
+}
+
+BOOST_AUTO_TEST_CASE(arch_dependent_values)
+{
+    const auto& arm64 = *find_arch("aarch64");
+    const auto& x86_64 = *find_arch("x86_64");
+    BOOST_TEST(find_constant("O_DIRECTORY").value() == 0200000u);
+    BOOST_TEST(find_constant("O_DIRECTORY", x86_64).value() == 0200000u);
+    BOOST_TEST(find_constant("O_DIRECTORY", arm64).value() == 040000u);
+    BOOST_TEST(find_constant("O_LARGEFILE", *find_arch("arm")).value() ==
+               0400000u);
+    BOOST_TEST(find_constant("O_CLOEXEC", arm64).value() == 02000000u);
+    BOOST_TEST(depends_on_arch("O_DIRECT"));
+    BOOST_TEST(!depends_on_arch("O_CLOEXEC"));
+
+    auto ast = parse(R"(
+        ALLOW { openat(dirfd, path, flags) { flags == O_DIRECTORY | 1 } }
+    )");
+    Diagnostics diagnostics;
+    std::array archs{x86_64, arm64};
+    auto table = lower(diagnostics, ast, archs);
+    BOOST_REQUIRE(!diagnostics.has_errors());
+
+    auto value = [&](const ir::ArchTable& t) {
+        const auto& guard = t.syscalls.begin()->second.entries.front().guard;
+        const auto& cmp = std::get<ast::EqExpr>(*guard.body.front());
+        return std::get<ast::IntLit>(*cmp.right).value;
+    };
+    BOOST_TEST(value(table.archs[0]) == 0200001);
+    BOOST_TEST(value(table.archs[1]) == 040001);
+}
+
+BOOST_AUTO_TEST_CASE(division_by_zero_on_some_arch)
+{
+    auto ast = parse(R"(
+        ALLOW {
+            openat(dirfd, path, flags) { flags == 1 / (O_DIRECT - 0x10000) }
+        }
+    )");
+    Diagnostics diagnostics;
+    std::array archs{*find_arch("x86_64"), *find_arch("aarch64")};
+    lower(diagnostics, ast, archs);
+    BOOST_REQUIRE(diagnostics.logs.size() == 1u);
+    BOOST_TEST(
+        diagnostics.logs.front().message == "Division by zero on aarch64");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,518 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+// Differential testing of the BPF backend. Random programs are compiled at
+// every optimisation level and the emulated filter is checked against a
+// direct interpretation of the AST (`eval()` with the parameters bound to the
+// syscall arguments) for random seccomp_data values. The two expression
+// parsers are also run on random token sequences and must build the same
+// trees.
+//
+// FEKAL_FUZZ_SEED and FEKAL_FUZZ_ITERATIONS override the defaults so longer
+// campaigns can be run by hand. Failures report the seed, the program and the
+// seccomp_data that exposed them.
+
+#define BOOST_TEST_MODULE Differential
+
+#include <fekal/compiler.hpp>
+#include <fekal/parser.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/hana/functional/overload.hpp>
+#include <unordered_set>
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <format>
+#include <random>
+
+using namespace fekal;
+
+namespace hana = boost::hana;
+
+// `fork` is absent on the asm-generic archs
+static constexpr std::array<std::string_view, 9> syscall_pool{
+    "read", "write", "close", "ioctl", "personality", "socket", "mmap",
+    "futex", "fork",
+};
+
+static constexpr std::array<std::string_view, 4> param_pool{
+    "a", "b", "c", "d",
+};
+
+static constexpr std::array<std::uint64_t, 12> interesting_values{
+    0, 1, 8, 0xff, 0x7fffffff, 0x80000000, 0xffffffff, 0x100000000,
+    0x100000001, 0x7fffffffffffffff, 0x8000000000000000, 0xffffffffffffffff,
+};
+
+class Generator
+{
+public:
+    Generator(std::uint64_t seed) : rng{seed} {}
+
+    std::string program()
+    {
+        literals.clear();
+        std::string out;
+        unsigned npolicies = pick(0, 3);
+        for (unsigned i = 0 ; i < npolicies ; ++i) {
+            out += std::format("POLICY P{} 0 {{\n", i);
+            if (i > 0 && chance(2)) {
+                out += std::format("    USE P{} 0\n", pick(0, i - 1));
+            }
+            for (unsigned n = pick(1, 2) ; n > 0 ; --n) {
+                out += action_block();
+            }
+            out += "}\n";
+        }
+        for (unsigned i = 0 ; i < npolicies ; ++i) {
+            if (chance(2)) {
+                out += std::format("USE P{} 0\n", i);
+            }
+        }
+        for (unsigned n = pick(npolicies == 0 ? 1 : 0, 2) ; n > 0 ; --n) {
+            out += action_block();
+        }
+        if (chance(2)) {
+            out += std::format("DEFAULT {}\n", action());
+        }
+        return out;
+    }
+
+    std::uint64_t value()
+    {
+        switch (pick(0, 3)) {
+        case 0:
+            return interesting_values[pick(0, interesting_values.size() - 1)];
+        case 1:
+            if (!literals.empty()) {
+                return literals[pick(0, literals.size() - 1)];
+            }
+            [[fallthrough]];
+        case 2:
+            return std::uniform_int_distribution<std::uint32_t>{}(rng);
+        default:
+            return std::uniform_int_distribution<std::uint64_t>{}(rng);
+        }
+    }
+
+    unsigned pick(std::size_t min, std::size_t max)
+    {
+        return std::uniform_int_distribution<std::size_t>{min, max}(rng);
+    }
+
+    bool chance(unsigned one_in)
+    {
+        return pick(1, one_in) == 1;
+    }
+
+private:
+    std::string action()
+    {
+        switch (pick(0, 7)) {
+        case 0: return "ALLOW";
+        case 1: return "LOG";
+        case 2: return "KILL_PROCESS";
+        case 3: return "KILL_THREAD";
+        case 4: return "USER_NOTIF";
+        case 5: return std::format("ERRNO({})", pick(0, 0xffff));
+        case 6: return std::format("TRAP({})", pick(0, 0xffff));
+        default: return std::format("TRACE({})", pick(0, 0xffff));
+        }
+    }
+
+    std::string action_block()
+    {
+        std::string out = std::format("{} {{\n", action());
+        std::unordered_set<std::string_view> used;
+        for (unsigned n = pick(1, 4) ; n > 0 ; --n) {
+            auto syscall = syscall_pool[pick(0, syscall_pool.size() - 1)];
+            if (!used.insert(syscall).second) {
+                continue;
+            }
+            out += "    " + filter(syscall) + ",\n";
+        }
+        return out + "}\n";
+    }
+
+    std::string filter(std::string_view syscall)
+    {
+        nparams = pick(0, param_pool.size());
+        if (nparams == 0) {
+            return std::string{syscall};
+        }
+        std::string out{syscall};
+        out += "(";
+        for (unsigned i = 0 ; i < nparams ; ++i) {
+            out += std::format("{}{}", i ? ", " : "", param_pool[i]);
+        }
+        out += ") {";
+        for (unsigned n = pick(0, 2) ; n > 0 ; --n) {
+            out += std::format(" {},", bool_expr(3));
+        }
+        return out + " }";
+    }
+
+    std::string bool_expr(unsigned depth)
+    {
+        switch (depth > 0 ? pick(0, 5) : 0) {
+        case 1:
+            return std::format(
+                "({} && {})", bool_expr(depth - 1), bool_expr(depth - 1));
+        case 2:
+            return std::format(
+                "({} || {})", bool_expr(depth - 1), bool_expr(depth - 1));
+        case 3:
+            return std::format("!({})", bool_expr(depth - 1));
+        default: {
+            static constexpr std::array<std::string_view, 6> ops{
+                "==", "!=", "<", ">", "<=", ">=",
+            };
+            return std::format(
+                "{} {} {}", int_expr(3), ops[pick(0, ops.size() - 1)],
+                int_expr(3));
+        }
+        }
+    }
+
+    // Arithmetic is only accepted on constants
+    std::string int_expr(unsigned depth)
+    {
+        static constexpr std::array<std::string_view, 3> bitwise{
+            "&", "|", "^",
+        };
+        switch (depth > 0 ? pick(0, 4) : pick(0, 1)) {
+        case 0:
+            if (nparams > 0) {
+                return std::string{param_pool[pick(0, nparams - 1)]};
+            }
+            [[fallthrough]];
+        case 1:
+            return literal();
+        case 4:
+            return const_expr(depth);
+        default:
+            return std::format(
+                "({} {} {})", int_expr(depth - 1),
+                bitwise[pick(0, bitwise.size() - 1)], int_expr(depth - 1));
+        }
+    }
+
+    std::string const_expr(unsigned depth)
+    {
+        static constexpr std::array<std::string_view, 8> ops{
+            "+", "-", "*", "/", "<<", ">>", "&", "|",
+        };
+        if (depth == 0) {
+            return literal();
+        }
+        auto op = ops[pick(0, ops.size() - 1)];
+        if (op == "/") {
+            // the divisor must not fold to zero
+            return std::format(
+                "({} / {})", const_expr(depth - 1), pick(1, 0xffff));
+        }
+        if (op == "<<" || op == ">>") {
+            return std::format(
+                "({} {} {})", const_expr(depth - 1), op, pick(0, 70));
+        }
+        return std::format(
+            "({} {} {})", const_expr(depth - 1), op, const_expr(depth - 1));
+    }
+
+    std::string literal()
+    {
+        auto v = value();
+        literals.push_back(v);
+        return std::format("{:#x}", v);
+    }
+
+    std::mt19937_64 rng;
+    std::vector<std::uint64_t> literals;
+    unsigned nparams = 0;
+};
+
+static unsigned precedence(const ast::Action& action)
+{
+    return std::visit(hana::overload(
+        [](const ast::ActionAllow&) { return 0; },
+        [](const ast::ActionLog&) { return 1; },
+        [](const ast::ActionTrace&) { return 2; },
+        [](const ast::ActionUserNotif&) { return 3; },
+        [](const ast::ActionErrno&) { return 4; },
+        [](const ast::ActionTrap&) { return 5; },
+        [](const ast::ActionKillThread&) { return 6; },
+        [](const ast::ActionKillProcess&) { return 7; }
+    ), action);
+}
+
+static std::uint32_t action_value(const ast::Action& action)
+{
+    return std::visit(hana::overload(
+        [](const ast::ActionAllow&) { return SECCOMP_RET_ALLOW; },
+        [](const ast::ActionLog&) { return SECCOMP_RET_LOG; },
+        [](const ast::ActionKillProcess&) { return SECCOMP_RET_KILL_PROCESS; },
+        [](const ast::ActionKillThread&) { return SECCOMP_RET_KILL_THREAD; },
+        [](const ast::ActionUserNotif&) { return SECCOMP_RET_USER_NOTIF; },
+        [](const ast::ActionErrno& a) {
+            return SECCOMP_RET_ERRNO | (a.errnum & SECCOMP_RET_DATA); },
+        [](const ast::ActionTrap& a) {
+            return SECCOMP_RET_TRAP |
+                (static_cast<std::uint32_t>(a.code) & SECCOMP_RET_DATA); },
+        [](const ast::ActionTrace& a) {
+            return SECCOMP_RET_TRACE |
+                (static_cast<std::uint32_t>(a.code) & SECCOMP_RET_DATA); }
+    ), action);
+}
+
+// Decides the action straight from the AST. Deliberately naive: USE
+// statements are expanded every time.
+class Interpreter
+{
+public:
+    Interpreter(const std::vector<ast::ProgramStatement>& ast) : ast{ast} {}
+
+    std::uint32_t decide(
+        std::span<const Arch> archs, const seccomp_data& data)
+    {
+        auto arch = std::ranges::find(archs, data.arch, &Arch::token);
+        if (arch == archs.end()) {
+            return SECCOMP_RET_KILL_PROCESS;
+        }
+        if (
+            arch->foreign_abi_bit != 0 &&
+            (static_cast<std::uint32_t>(data.nr) & arch->foreign_abi_bit)
+        ) {
+            return SECCOMP_RET_KILL_PROCESS;
+        }
+
+        best.reset();
+        expanded.clear();
+        std::optional<std::uint32_t> default_value;
+        for (const auto& stmt : ast) {
+            std::visit(hana::overload(
+                [](const ast::Policy&) {},
+                [&](const ast::DefaultAction& a) {
+                    default_value = action_value(a);
+                },
+                [&](const auto& stmt) { add(stmt, *arch, data); }
+            ), stmt);
+        }
+        if (best) {
+            return best->second;
+        }
+        return default_value.value_or(SECCOMP_RET_KILL_PROCESS);
+    }
+
+private:
+    void add(
+        const ast::ActionBlock& block, const Arch& arch,
+        const seccomp_data& data)
+    {
+        for (const auto& filter : block.filters) {
+            auto nr = resolve_syscall(arch, filter.syscall);
+            if (!nr || *nr != static_cast<std::uint32_t>(data.nr)) {
+                continue;
+            }
+            Bindings bindings;
+            for (std::size_t i = 0 ; i < filter.params.size() ; ++i) {
+                bindings[std::string{filter.params[i].value}] = data.args[i];
+            }
+            bool match = filter.body.empty() ||
+                std::ranges::any_of(filter.body, [&](const auto& expr) {
+                    return eval(*expr, bindings);
+                });
+            auto p = precedence(block.action);
+            if (match && (!best || p > best->first)) {
+                best.emplace(p, action_value(block.action));
+            }
+        }
+    }
+
+    void add(
+        const ast::UseStatement& stmt, const Arch& arch,
+        const seccomp_data& data)
+    {
+        if (!expanded.insert(stmt.key()).second) {
+            return;
+        }
+        for (const auto& s : ast) {
+            auto policy = std::get_if<ast::Policy>(&s);
+            if (!policy || policy->key() != stmt.key()) {
+                continue;
+            }
+            for (const auto& s : policy->body) {
+                std::visit([&](const auto& s) { add(s, arch, data); }, s);
+            }
+        }
+    }
+
+    const std::vector<ast::ProgramStatement>& ast;
+    std::optional<std::pair<unsigned, std::uint32_t>> best;
+    std::unordered_set<SymbolKey> expanded;
+};
+
+static seccomp_data random_data(
+    Generator& gen, std::span<const Arch> archs)
+{
+    const auto& all = supported_archs();
+    seccomp_data data{};
+    const Arch* arch = nullptr;
+    if (gen.chance(16)) {
+        data.arch = 0xdeadbeef;
+    } else if (gen.chance(4)) {
+        arch = &all[gen.pick(0, all.size() - 1)];
+    } else {
+        arch = &archs[gen.pick(0, archs.size() - 1)];
+    }
+
+    if (arch) {
+        data.arch = arch->token;
+        auto syscall = syscall_pool[gen.pick(0, syscall_pool.size() - 1)];
+        auto nr = resolve_syscall(*arch, syscall);
+        data.nr = static_cast<int>(nr.value_or(gen.pick(0, 1023)));
+        if (arch->foreign_abi_bit != 0 && gen.chance(8)) {
+            data.nr |= arch->foreign_abi_bit;
+        }
+    }
+
+    for (auto& arg : data.args) {
+        arg = gen.value();
+        // the kernel zero-extends arguments from 32-bit ABIs
+        if (arch && !arch->is_64bit) {
+            arg &= 0xffffffff;
+        }
+    }
+    return data;
+}
+
+// Operands joined by any binary operator and parenthesised at random, so
+// chains mix every precedence level. A few stray tokens make some inputs stop
+// early, on a dangling operator or an unbalanced parenthesis.
+static std::string expression_tokens(Generator& gen)
+{
+    static constexpr std::array<std::string_view, 17> binary{
+        "||", "&&", "==", "!=", "<", ">", "<=", ">=", "|", "^", "&", "<<",
+        ">>", "+", "-", "*", "/",
+    };
+    static constexpr std::array<std::string_view, 4> stray{
+        "(", ")", "!", "==",
+    };
+
+    std::string out;
+    unsigned depth = 0;
+    for (unsigned n = gen.pick(1, 16) ; n > 0 ; --n) {
+        while (gen.chance(4)) {
+            out += gen.chance(3) ? "!( " : "( ";
+            ++depth;
+        }
+        if (gen.chance(2)) {
+            out += std::format("{} ", param_pool[gen.pick(0, 3)]);
+        } else {
+            out += std::format("{} ", gen.pick(0, 9));
+        }
+        while (depth > 0 && gen.chance(3)) {
+            out += ") ";
+            --depth;
+        }
+        if (gen.chance(20)) {
+            out += std::format("{} ", stray[gen.pick(0, stray.size() - 1)]);
+        }
+        if (n > 1) {
+            out += std::format("{} ", binary[gen.pick(0, binary.size() - 1)]);
+        }
+    }
+    if (gen.chance(4)) {
+        depth = 0;
+    }
+    for (; depth > 0 ; --depth) {
+        out += ") ";
+    }
+    return out;
+}
+
+static std::uint64_t env_or(const char* name, std::uint64_t fallback)
+{
+    auto v = std::getenv(name);
+    return v ? std::stoull(v) : fallback;
+}
+
+BOOST_AUTO_TEST_CASE(emulated_filter_matches_ast)
+{
+    auto seed = env_or("FEKAL_FUZZ_SEED", 0x5eccc0b);
+    auto iterations = env_or("FEKAL_FUZZ_ITERATIONS", 400);
+    Generator gen{seed};
+
+    const auto& all = supported_archs();
+    std::vector<std::vector<Arch>> arch_sets{
+        {all[0]},
+        {all[1]},
+        std::vector<Arch>(all.begin(), all.end()),
+    };
+
+    for (std::uint64_t i = 0 ; i < iterations ; ++i) {
+        auto source = gen.program();
+        Compiler compiler;
+        auto ast = compiler.compile(source);
+        BOOST_REQUIRE_MESSAGE(
+            !compiler.diagnostics.has_errors(),
+            std::format("seed {} rejected program:\n{}", seed, source));
+
+        Interpreter interpreter{ast};
+        for (unsigned level = 0 ; level <= PassManager::max_level ; ++level)
+        for (const auto& archs : arch_sets) {
+            compiler.passes.set_level(level);
+            auto program = compiler.codegen(ast, archs);
+            BOOST_REQUIRE(!program.empty());
+
+            for (unsigned n = 0 ; n < 64 ; ++n) {
+                auto data = random_data(gen, archs);
+                auto expected = interpreter.decide(archs, data);
+                auto actual = bpf::emulate(program, data).action;
+                if (actual == expected) {
+                    continue;
+                }
+
+                std::ostringstream args;
+                for (auto arg : data.args) {
+                    args << std::format(" {:#x}", arg);
+                }
+                BOOST_ERROR(std::format(
+                    "seed {} iteration {} -O{}: arch={:#x} nr={} args={}: "
+                    "expected {:#x}, got {:#x}\n{}",
+                    seed, i, level, data.arch, data.nr, args.str(), expected,
+                    actual, source));
+                return;
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(expression_parsers_agree)
+{
+    auto seed = env_or("FEKAL_FUZZ_SEED", 0x5eccc0b);
+    auto iterations = env_or("FEKAL_FUZZ_ITERATIONS", 400) * 50;
+    Generator gen{seed};
+
+    unsigned matched = 0;
+    for (std::uint64_t i = 0 ; i < iterations ; ++i) {
+        auto source = expression_tokens(gen);
+        auto [peg, peg_end] = parse_expression(source, ExpressionParser::peg);
+        auto [climbing, climbing_end] = parse_expression(
+            source, ExpressionParser::precedence_climbing);
+
+        bool same = static_cast<bool>(peg) == static_cast<bool>(climbing) &&
+            peg_end == climbing_end && (!peg || *peg == *climbing);
+        if (!same) {
+            BOOST_ERROR(std::format(
+                "seed {} iteration {}: parsers disagree (stopped at {} and "
+                "{}) on:\n{}",
+                seed, i, peg_end, climbing_end, source));
+            return;
+        }
+        matched += static_cast<bool>(peg);
+    }
+
+    // most inputs are well-formed, but not all
+    BOOST_TEST(matched > iterations / 4);
+    BOOST_TEST(matched < iterations);
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/exprtable.hpp>
+#include <fekal/parser.hpp>
+#include <boost/test/unit_test.hpp>
+#include <format>
+
+using namespace fekal;
+
+BOOST_AUTO_TEST_SUITE(expr_table)
+
+static std::vector<std::shared_ptr<ast::BoolExpr>> bodies(
+    const std::vector<ast::ProgramStatement>& ast)
+{
+    std::vector<std::shared_ptr<ast::BoolExpr>> ret;
+    for (const auto& stmt : ast) {
+        auto policy = std::get_if<ast::Policy>(&stmt);
+        if (!policy) {
+            continue;
+        }
+        for (const auto& stmt : policy->body) {
+            for (const auto& filter : std::get<ast::ActionBlock>(stmt).filters) {
+                ret.insert(ret.end(), filter.body.begin(), filter.body.end());
+            }
+        }
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(identical_expressions_share_a_node)
+{
+    auto ast = parse(R"(
+        POLICY A 0 {
+            ALLOW { socket(domain) { domain == 1 && domain != 2 } }
+        }
+        POLICY B 0 {
+            ALLOW {
+                socketpair(domain) {
+                    domain == 1 && domain != 2
+                },
+                bind(domain) { domain == 1 }
+            }
+        }
+    )");
+    ExprTable table;
+    table.intern(ast);
+
+    auto exprs = bodies(ast);
+    BOOST_REQUIRE(exprs.size() == 3u);
+    BOOST_TEST(exprs[0] == exprs[1]);
+    BOOST_TEST(std::get<ast::AndExpr>(*exprs[0]).left == exprs[2].get());
+
+    // domain, 1, 2, ==, !=, &&
+    BOOST_TEST(table.size() == 6u);
+}
+
+BOOST_AUTO_TEST_CASE(different_expressions_are_kept_apart)
+{
+    auto ast = parse(R"(
+        POLICY A 0 { ALLOW { read(fd) { fd == 1 } } }
+        POLICY B 0 { ALLOW { read(fd) { fd <= 1 } } }
+        POLICY C 0 { ALLOW { read(count) { count == 1 } } }
+    )");
+    ExprTable{}.intern(ast);
+
+    auto exprs = bodies(ast);
+    BOOST_TEST(exprs[0] != exprs[1]);
+    BOOST_TEST(exprs[0] != exprs[2]);
+    BOOST_TEST(!equivalent(*exprs[0], *exprs[2]));
+}
+
+BOOST_AUTO_TEST_CASE(generated_predicates)
+{
+    // 20000 predicates over 100 distinct values
+    std::string source = "POLICY P 0 { ALLOW {\n";
+    for (unsigned i = 0 ; i < 20000 ; ++i) {
+        source += std::format(
+            "    ioctl(fd, request) {{ request == {} && fd < 1000 }},\n",
+            i % 100);
+    }
+    source += "} }\n";
+    auto ast = parse(source);
+    ExprTable table;
+    table.intern(ast);
+
+    // fd, request, 1000, fd < 1000, plus a literal, `==` and `&&` per value
+    BOOST_TEST(table.size() == 4u + 3u * 100u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+// Compiles every policy from the example library for each supported arch and
+// compares the program length and the worst-case path of every syscall
+// against a checked-in baseline. Growth fails the test.
+//
+// Usage: test_instruction_count -- <policies.fekal> <baseline>
+//
+// After an intended change (or an update to libseccomp's syscall tables), run
+// with FEKAL_UPDATE_GOLDEN=1 to rewrite the baseline. Each line holds:
+//
+//     <arch> <policy> <program length> [<syscall>=<worst-case path>]...
+
+#define BOOST_TEST_MODULE InstructionCount
+
+#include <fekal/compiler.hpp>
+#include <fekal/parser.hpp>
+#include <fekal/sourcefile.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <format>
+#include <map>
+
+using namespace fekal;
+
+struct Measure
+{
+    std::size_t length;
+    std::map<std::string, unsigned> paths;
+};
+
+// Keyed by "<arch> <policy>"
+using Baseline = std::map<std::string, Measure>;
+
+static Baseline parse_baseline(std::istream& in)
+{
+    Baseline ret;
+    for (std::string line ; std::getline(in, line) ;) {
+        std::istringstream ls{line};
+        std::string arch, policy;
+        Measure m;
+        if (!(ls >> arch >> policy >> m.length)) {
+            continue;
+        }
+        for (std::string entry ; ls >> entry ;) {
+            auto eq = entry.find('=');
+            m.paths[entry.substr(0, eq)] = std::stoul(entry.substr(eq + 1));
+        }
+        ret.emplace(arch + " " + policy, std::move(m));
+    }
+    return ret;
+}
+
+static Measure measure(
+    const std::string& library, const ast::Policy& policy, const Arch& arch)
+{
+    auto source = std::format(
+        "{}\nUSE {} {}\n", library, policy.name, policy.version);
+    Compiler compiler;
+    auto ast = compiler.compile(source);
+    auto program = compiler.codegen(ast, std::span{&arch, 1});
+    BOOST_REQUIRE(!compiler.diagnostics.has_errors());
+
+    Measure ret{program.size(), {}};
+    for (const auto& stmt : policy.body) {
+        auto block = std::get_if<ast::ActionBlock>(&stmt);
+        if (!block) {
+            continue;
+        }
+        for (const auto& filter : block->filters) {
+            if (auto nr = resolve_syscall(arch, filter.syscall) ; nr) {
+                ret.paths[std::string{filter.syscall}] = bpf::worst_case_path(
+                    program, arch.token, *nr);
+            }
+        }
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(example_policies)
+{
+    auto& suite = boost::unit_test::framework::master_test_suite();
+    BOOST_REQUIRE_EQUAL(suite.argc, 3);
+    auto source = SourceFile::open(suite.argv[1]);
+    std::string library{source.text()};
+    std::string baseline_path = suite.argv[2];
+
+    Baseline current;
+    for (const auto& stmt : parse(library)) {
+        auto policy = std::get_if<ast::Policy>(&stmt);
+        if (!policy) {
+            continue;
+        }
+        for (const auto& arch : supported_archs()) {
+            current.emplace(
+                std::format("{} {}", arch.name, policy->name),
+                measure(library, *policy, arch));
+        }
+    }
+
+    if (std::getenv("FEKAL_UPDATE_GOLDEN")) {
+        std::ofstream out{baseline_path};
+        for (const auto& [key, m] : current) {
+            out << key << ' ' << m.length;
+            for (const auto& [syscall, path] : m.paths) {
+                out << ' ' << syscall << '=' << path;
+            }
+            out << '\n';
+        }
+        BOOST_TEST_MESSAGE("baseline updated");
+        return;
+    }
+
+    std::ifstream in{baseline_path};
+    BOOST_REQUIRE(in);
+    auto baseline = parse_baseline(in);
+
+    for (const auto& [key, m] : current) {
+        auto it = baseline.find(key);
+        if (it == baseline.end()) {
+            BOOST_ERROR(std::format("{}: missing from baseline", key));
+            continue;
+        }
+        const auto& base = it->second;
+        BOOST_TEST(
+            m.length <= base.length,
+            std::format(
+                "{}: program grew from {} to {} instructions", key,
+                base.length, m.length));
+        for (const auto& [syscall, path] : m.paths) {
+            auto it = base.paths.find(syscall);
+            // syscalls only newly known to libseccomp have no baseline
+            if (it == base.paths.end()) {
+                continue;
+            }
+            BOOST_TEST(
+                path <= it->second,
+                std::format(
+                    "{}: worst-case path of {} grew from {} to {}", key,
+                    syscall, it->second, path));
+        }
+    }
+}
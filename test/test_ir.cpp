@@ -0,0 +1,197 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/codegen.hpp>
+#include <fekal/simplify.hpp>
+#include <fekal/parser.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <sstream>
+
+#include "helpers.hpp"
+
+using namespace fekal;
+
+BOOST_AUTO_TEST_SUITE(ir_passes)
+
+struct Lowered
+{
+    std::vector<ast::ProgramStatement> ast;
+    Diagnostics diagnostics;
+    ir::DecisionTable table;
+
+    explicit Lowered(std::string_view source)
+        : ast{parse(source)}
+        , table{lower(diagnostics, ast, std::span{&supported_archs()[0], 1})}
+    {
+        BOOST_REQUIRE(!diagnostics.has_errors());
+    }
+
+    const std::vector<ir::Entry>& entries(std::string_view syscall) const
+    {
+        for (const auto& [nr, s] : table.archs.front().syscalls) {
+            if (s.name == syscall) {
+                return s.entries;
+            }
+        }
+        throw std::out_of_range{std::string{syscall}};
+    }
+};
+
+BOOST_AUTO_TEST_CASE(unconditional_rule_subsumes_guarded_one)
+{
+    Lowered l{R"(
+        POLICY Restricted 0 { ALLOW { ioctl(fd, request) { request == 1 } } }
+        POLICY Plain 0 { ALLOW { ioctl } }
+        USE Restricted 0
+        USE Plain 0
+    )"};
+    eliminate_redundant_rules(l.diagnostics, l.table);
+
+    const auto& entries = l.entries("ioctl");
+    BOOST_REQUIRE(entries.size() == 1u);
+    BOOST_TEST(entries.front().unconditional());
+    BOOST_TEST(count(l.diagnostics, Hint) == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(dropped_rules_are_printed)
+{
+    Lowered l{R"(
+        ALLOW { ioctl }
+        ALLOW { ioctl(fd, request) { request == 1 } }
+    )"};
+    eliminate_redundant_rules(l.diagnostics, l.table);
+
+    std::ostringstream out;
+    l.diagnostics.print(out);
+    BOOST_TEST(
+        out.str() ==
+        "Hint Rule for `ioctl` dropped: shadowed by an unconditional rule\n");
+}
+
+BOOST_AUTO_TEST_CASE(stronger_guarded_rule_is_kept)
+{
+    Lowered l{R"(
+        KILL_PROCESS { ioctl(fd, request) { request == 1 } }
+        ALLOW { ioctl }
+    )"};
+    eliminate_redundant_rules(l.diagnostics, l.table);
+
+    BOOST_TEST(l.entries("ioctl").size() == 2u);
+    BOOST_TEST(count(l.diagnostics, Hint) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(same_action_bodies_are_merged)
+{
+    Lowered l{R"(
+        POLICY Tcp 0 { ALLOW { socket(domain, type) { domain == 2 } } }
+        POLICY Unix 0 { ALLOW { socket(domain) { domain == 1 } } }
+        POLICY Dup 0 { ALLOW { socket(domain) { domain == 1 } } }
+        USE Tcp 0
+        USE Unix 0
+        USE Dup 0
+    )"};
+    eliminate_redundant_rules(l.diagnostics, l.table);
+
+    const auto& entries = l.entries("socket");
+    BOOST_REQUIRE(entries.size() == 1u);
+    BOOST_TEST(entries.front().guard.body.size() == 2u);
+    BOOST_TEST(entries.front().guard.params.size() == 2u);
+
+    // only the duplicate is dropped, merging isn't reported
+    BOOST_TEST(count(l.diagnostics, Hint) == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(reshaped_bodies_forget_where_written)
+{
+    Lowered l{R"(
+        ALLOW { socket(domain) { domain == 2 } }
+        ALLOW { socket(domain) { domain == 1 } }
+        ERRNO(1) { open(path, flags) { flags == 0 } }
+        ALLOW { open(path, flags) { flags == 0, flags == 1 } }
+    )"};
+    BOOST_REQUIRE(!l.entries("socket").front().written.empty());
+    eliminate_redundant_rules(l.diagnostics, l.table);
+
+    // positions would no longer line up with the body
+    BOOST_REQUIRE(l.entries("socket").size() == 1u);
+    BOOST_TEST(l.entries("socket").front().written.empty());
+    BOOST_REQUIRE(l.entries("open").size() == 2u);
+    BOOST_TEST(l.entries("open").back().guard.body.size() == 1u);
+    BOOST_TEST(l.entries("open").back().written.empty());
+}
+
+BOOST_AUTO_TEST_CASE(shadowed_rules_are_reported)
+{
+    Lowered l{R"(
+        KILL_PROCESS { ptrace }
+        ALLOW { ptrace(request) { request == 0 } }
+    )"};
+    eliminate_redundant_rules(l.diagnostics, l.table);
+
+    BOOST_TEST(l.entries("ptrace").size() == 1u);
+    BOOST_TEST(count(l.diagnostics, Hint) == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(tautology_makes_rule_unconditional)
+{
+    Lowered l{R"(
+        ALLOW { read(fd) { fd >= 0 } }
+    )"};
+    simplify_guards(l.diagnostics, l.table);
+
+    BOOST_TEST(l.entries("read").front().unconditional());
+    BOOST_TEST(count(l.diagnostics, Warning) == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(contradiction_removes_rule)
+{
+    Lowered l{R"(
+        ALLOW {
+            read(fd) { fd == 1 && fd == 2 },
+            write(fd) { (fd & 0x3) == 1 && (fd | 0x2) < 2 },
+            close(fd) { fd == 1 }
+        }
+    )"};
+    simplify_guards(l.diagnostics, l.table);
+
+    BOOST_TEST(l.entries("read").empty());
+    BOOST_TEST(l.entries("write").empty());
+    BOOST_TEST(l.entries("close").size() == 1u);
+    BOOST_TEST(count(l.diagnostics, Warning) == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(decided_conjuncts_are_folded)
+{
+    Lowered l{R"(
+        ALLOW { mmap(addr, len) { addr == 0 && len <= 0xffffffffffffffff } }
+    )"};
+    simplify_guards(l.diagnostics, l.table);
+
+    const auto& body = l.entries("mmap").front().guard.body;
+    BOOST_REQUIRE(body.size() == 1u);
+    BOOST_TEST(std::holds_alternative<ast::EqExpr>(*body.front()));
+    BOOST_TEST(count(l.diagnostics, Warning) == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(merged_expressions_are_reported_where_written)
+{
+    Lowered l{R"(
+        ALLOW {
+            read(fd) { fd >= 0 },
+            write(fd) { fd == 1 || fd >= 0 }
+        }
+    )"};
+    simplify_guards(l.diagnostics, l.table);
+
+    BOOST_REQUIRE(count(l.diagnostics, Warning) == 2u);
+    std::vector<std::pair<unsigned, unsigned>> positions;
+    for (const auto& log : l.diagnostics.logs) {
+        positions.emplace_back(log.range.start.line, log.range.start.column);
+    }
+    std::ranges::sort(positions);
+    BOOST_TEST((positions[0] != positions[1]));
+    BOOST_TEST(positions[0].first + 1 == positions[1].first);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
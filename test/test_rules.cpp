@@ -0,0 +1,164 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/checker/rules.hpp>
+#include <fekal/checker.hpp>
+#include <fekal/compiler.hpp>
+#include <fekal/parser.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <format>
+
+#include "helpers.hpp"
+
+using namespace fekal;
+
+BOOST_AUTO_TEST_SUITE(rule_checks)
+
+BOOST_AUTO_TEST_CASE(filters_reach_only_their_rules)
+{
+    auto ast = parse(R"(
+        POLICY A 0 { ALLOW { read, socket, write } }
+        POLICY B 0 { ALLOW { socket, bind } }
+        USE A 0
+        ALLOW { socketpair, read }
+    )");
+    Context context;
+    Diagnostics diagnostics;
+    context.unreachable.insert(&std::get<ast::Policy>(ast[1]));
+
+    std::vector<std::string_view> seen;
+    auto record = [&](auto&, auto&, const ast::SyscallFilter& filter) {
+        seen.push_back(filter.syscall);
+    };
+    SyscallRule sockets{{"socket", "socketpair"}, record};
+    SyscallRule reads{{"read"}, record};
+    RuleSet rules;
+    rules.add(sockets);
+    rules.add(reads);
+    rules.check(context, diagnostics, ast);
+
+    BOOST_TEST(
+        seen == (std::vector<std::string_view>{
+            "read", "socket", "socketpair", "read"}),
+        boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(open_flags)
+{
+    Compiler compiler;
+    compiler.compile(R"(
+        ALLOW {
+            openat(dirfd, path, flags) { flags == O_RDONLY },
+            open(path, flags) { flags == O_NOPE },
+            read(fd, buf) { buf == fd }
+        }
+    )");
+    BOOST_TEST(count(compiler.diagnostics, Severity::Error) == 1u);
+
+    compiler.reset();
+    compiler.passes.set_enabled("syscall-open", false);
+    compiler.compile("ALLOW { open(path, flags) { flags == O_NOPE } }");
+    BOOST_TEST(count(compiler.diagnostics, Severity::Error) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(threads_are_opt_in)
+{
+    PassManager passes;
+    BOOST_TEST(passes.jobs == 1u);
+    BOOST_TEST(passes.parse_option("-j4"));
+    BOOST_TEST(passes.jobs == 4u);
+    BOOST_TEST(passes.parse_option("-j"));
+    BOOST_TEST(passes.jobs == 0u);
+    BOOST_CHECK_THROW(passes.parse_option("-jx"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(output_is_independent_of_jobs)
+{
+    std::string source = "ALLOW {\n";
+    for (unsigned i = 0 ; i < 2000 ; ++i) {
+        source += std::format(
+            "    open(path, flags) {{ flags == O_{} || flags == O_RDWR }},\n",
+            i % 3 ? "RDONLY" : "BOGUS");
+        source += std::format(
+            "    openat(dirfd, path, flags) {{ flags == O_{} }},\n",
+            i % 3 ? "WRONLY" : "BOGUS");
+    }
+    source += "}\n";
+
+    auto run = [&](unsigned jobs) {
+        Compiler compiler;
+        compiler.passes.jobs = jobs;
+        compiler.compile(source);
+        std::vector<std::string> ret;
+        for (const auto& log : compiler.diagnostics.logs) {
+            ret.push_back(std::format(
+                "{}:{} {}", log.range.start.line, log.range.start.column,
+                log.message));
+        }
+        return ret;
+    };
+
+    auto expected = run(1);
+    auto invalid = std::ranges::count_if(expected, [](const auto& log) {
+        return log.find("Invalid oflag") != std::string::npos;
+    });
+    BOOST_TEST(invalid == 2 * 667);
+    for (unsigned jobs : {2u, 3u, 7u, 0u}) {
+        BOOST_TEST(run(jobs) == expected, boost::test_tools::per_element());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(timings_outlive_added_passes)
+{
+    Compiler compiler;
+    compiler.passes.time_passes = true;
+    compiler.compile("ALLOW { open(path, flags) { flags == O_RDONLY } }");
+    BOOST_REQUIRE(!compiler.passes.timings.empty());
+    auto names = compiler.passes.timings;
+
+    // grows the pass list past its capacity
+    for (unsigned i = 0 ; i < 64 ; ++i) {
+        compiler.passes.add(Pass{
+            std::format("noop-{}", i), 0, BpfPass{[](bpf::Program&) {}}});
+    }
+    for (std::size_t i = 0 ; i < names.size() ; ++i) {
+        BOOST_TEST(compiler.passes.timings[i].pass == names[i].pass);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(timings_start_over_after_reset)
+{
+    Compiler compiler;
+    compiler.passes.time_passes = true;
+    compiler.compile("ALLOW { open(path, flags) { flags == O_RDONLY } }");
+    auto first = compiler.passes.timings.size();
+
+    compiler.reset();
+    compiler.compile("ALLOW { open(path, flags) { flags == O_RDONLY } }");
+    BOOST_TEST(compiler.passes.timings.size() == first);
+}
+
+BOOST_AUTO_TEST_CASE(scopes_belong_to_their_context)
+{
+    auto ast = parse("ALLOW { open(path, flags) { flags == O_RDONLY } }");
+    auto other = parse("ALLOW { read(fd) { fd == 0 } }");
+    const auto& filter = std::get<ast::ActionBlock>(ast.front()).filters.front();
+    Diagnostics diagnostics;
+
+    Context first;
+    check(first, diagnostics, ast);
+    auto& scope = first.get_scope_by_node(filter);
+
+    // the same nodes open scopes at other positions in another context
+    Context second;
+    check(second, diagnostics, other);
+    check(second, diagnostics, ast);
+    BOOST_TEST(&first.get_scope_by_node(filter) == &scope);
+    BOOST_TEST(&second.get_scope_by_node(filter) != &scope);
+
+    first.reset();
+    BOOST_CHECK_THROW(first.get_scope_by_node(filter), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+// Copyright (c) 2025 Vinícius dos Santos Oliveira
+// SPDX-License-Identifier: MIT-0
+
+#include <fekal/uses.hpp>
+#include <fekal/compiler.hpp>
+#include <fekal/parser.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <format>
+#include <thread>
+
+#include "helpers.hpp"
+
+using namespace fekal;
+
+BOOST_AUTO_TEST_SUITE(use_resolution)
+
+BOOST_AUTO_TEST_CASE(diamond_is_expanded_once)
+{
+    auto ast = parse(R"(
+        POLICY R 0 { ALLOW { read } }
+        POLICY A 0 { USE R 0 ALLOW { write } }
+        POLICY B 0 { USE R 0 ALLOW { close } }
+        POLICY C 0 { USE A 0 USE B 0 }
+    )");
+    UseResolver resolver{ast};
+
+    auto c = resolver.resolve(symbol_key("C", "0"));
+    std::vector<std::string> syscalls;
+    for (const auto& e : *c) {
+        for (const auto& filter : e.block->filters) {
+            syscalls.emplace_back(filter.syscall);
+        }
+    }
+    BOOST_TEST(syscalls == (std::vector<std::string>{"read", "write", "close"}),
+               boost::test_tools::per_element());
+
+    // memoised
+    auto a = symbol_key("A", "0");
+    BOOST_TEST(resolver.resolve(a) == resolver.resolve(a));
+
+    Diagnostics diagnostics;
+    resolver.check(diagnostics);
+    BOOST_TEST(diagnostics.logs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(cycles_are_reported)
+{
+    auto ast = parse(R"(
+        POLICY A 0 { USE B 0 ALLOW { read } }
+        POLICY B 0 { USE C 0 }
+        POLICY C 0 { USE A 0 }
+        POLICY D 0 { USE D 0 }
+    )");
+    UseResolver resolver{ast};
+
+    Diagnostics diagnostics;
+    resolver.check(diagnostics);
+    BOOST_TEST(count(diagnostics, Error) == 2);
+
+    // still terminates
+    BOOST_TEST(resolver.resolve(symbol_key("A", "0"))->size() == 1);
+    BOOST_TEST(resolver.resolve(symbol_key("D", "0"))->empty());
+}
+
+BOOST_AUTO_TEST_CASE(duplicate_use_is_reported)
+{
+    auto ast = parse(R"(
+        POLICY A 0 { ALLOW { read } }
+        POLICY B 0 { USE A 0 USE A 0 }
+        USE B 0
+        USE B 0
+    )");
+    Diagnostics diagnostics;
+    UseResolver{ast}.check(diagnostics);
+    BOOST_TEST(count(diagnostics, Warning) == 2);
+    BOOST_TEST(count(diagnostics, Error) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(reachability_starts_at_top_level)
+{
+    auto ast = parse(R"(
+        POLICY A 0 { ALLOW { read } }
+        POLICY B 0 { USE A 0 }
+        POLICY C 0 { ALLOW { write } }
+        POLICY D 0 { USE C 0 }
+        USE B 0
+    )");
+    auto reachable = UseResolver{ast}.reachable();
+    std::vector<std::string> names;
+    for (const auto& stmt : ast) {
+        auto policy = std::get_if<ast::Policy>(&stmt);
+        if (policy && reachable.contains(policy)) {
+            names.emplace_back(policy->name);
+        }
+    }
+    BOOST_TEST(names == (std::vector<std::string>{"A", "B"}),
+               boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_policies_are_skipped)
+{
+    std::string_view source = R"(
+        POLICY A 0 { ALLOW { read, read } }
+        POLICY B 0 { ALLOW { write } }
+        USE B 0
+    )";
+
+    Compiler compiler;
+    compiler.compile(source);
+    BOOST_TEST(!compiler.diagnostics.has_errors());
+
+    Compiler strict;
+    strict.check_all = true;
+    strict.compile(source);
+    BOOST_TEST(strict.diagnostics.has_errors());
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_resolution)
+{
+    // each policy imports every previous one
+    std::string source;
+    for (unsigned i = 0 ; i < 200 ; ++i) {
+        source += std::format("POLICY P{} 0 {{\n", i);
+        for (unsigned j = 0 ; j < i ; ++j) {
+            source += std::format("    USE P{} 0\n", j);
+        }
+        source += "    ALLOW { read }\n}\n";
+    }
+    auto ast = parse(source);
+    UseResolver resolver{ast};
+
+    std::vector<std::size_t> sizes(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0 ; t < sizes.size() ; ++t) {
+        threads.emplace_back([&, t]() {
+            sizes[t] = resolver.resolve(symbol_key("P199", "0"))->size();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (auto size : sizes) {
+        BOOST_TEST(size == 200u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(name_and_version_stay_apart)
+{
+    Compiler compiler;
+    auto ast = compiler.compile(R"(
+        POLICY A1 0 { ALLOW { read } }
+        POLICY A 10 { ALLOW { write, close } }
+        USE A1 0
+        USE A 10
+    )");
+    BOOST_TEST(!compiler.diagnostics.has_errors());
+
+    UseResolver resolver{ast};
+    BOOST_TEST(resolver.resolve(symbol_key("A1", "0"))->size() == 1u);
+    const auto& a10 = *resolver.resolve(symbol_key("A", "10"));
+    BOOST_TEST(a10.front().block->filters.size() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(numeric_versions_are_normalized)
+{
+    Compiler compiler;
+    auto ast = compiler.compile(R"(
+        POLICY A 0x10 { ALLOW { read } }
+        POLICY B v2 { USE A 16 }
+        USE B v2
+    )");
+    BOOST_TEST(!compiler.diagnostics.has_errors());
+
+    UseResolver resolver{ast};
+    BOOST_TEST(resolver.resolve(symbol_key("A", "16"))->size() == 1u);
+    BOOST_TEST(resolver.resolve(symbol_key("B", "v2"))->size() == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()